@@ -4,6 +4,7 @@
 #include "battery_manager.h"
 #include "process_controller.h"
 #include "battery_reporter.h"
+#include "bus_benchmark.h"
 
 BatteryManager battery;
 ProcessController controller(battery);
@@ -19,6 +20,10 @@ void setup() {
 
   led_init();
   controller.init();
+
+#if BUS_BENCHMARK
+  bus_benchmark_run();
+#endif
   
   bool battery_found = false;
   for (int i = 0; i < BATTERY_CONNECT_RETRIES; i++) {
@@ -87,6 +92,10 @@ void handle_menu_input() {
       case 4:
         controller.start_discharge();
         break;
+
+      case 6:
+        controller.start_soh_estimate();
+        break;
         
       default:
         ui_print_message(F("Invalid choice. Please try again."));
@@ -98,10 +107,10 @@ void handle_menu_input() {
 
 int get_cycle_count() {
   int cycles = -1;
-  while (cycles < 0 || cycles > 5) {
+  while (cycles < 0 || cycles > MAX_CALIBRATION_CYCLES) {
     ui_prompt_for_cycles();
     cycles = ui_read_integer();
-    if (cycles < 0 || cycles > 5) {
+    if (cycles < 0 || cycles > MAX_CALIBRATION_CYCLES) {
       ui_prompt_invalid_cycles();
     }
   }
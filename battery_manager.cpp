@@ -27,21 +27,32 @@
 
 const byte SMBUS_ADDRESS = 0x0B;
 
-BatteryManager::BatteryManager() {
-  memset(&data, 0, sizeof(BatteryData));
+uint8_t valid_cell_voltages(const BatteryData& data, uint16_t cells[4]) {
+  const uint16_t readings[] = {data.cell_voltage_1, data.cell_voltage_2, data.cell_voltage_3, data.cell_voltage_4};
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    if (readings[i] != 0 && readings[i] != 0xFFFF) cells[count++] = readings[i];
+  }
+  return count;
+}
+
+template <class Bus>
+BasicBatteryManager<Bus>::BasicBatteryManager() {
+  data = BatteryData();
 }
 
-bool BatteryManager::connect() {
-  Wire.begin();
-  Wire.beginTransmission(SMBUS_ADDRESS);
-  byte error = Wire.endTransmission();
+template <class Bus>
+bool BasicBatteryManager<Bus>::connect() {
+  bus.begin();
+  byte error = bus.probe(SMBUS_ADDRESS);
   if (error != 0) {
     ui_print_message(String(F("Connection error: ")) + error);
   }
   return (error == 0);
 }
 
-bool BatteryManager::read_data() {
+template <class Bus>
+bool BasicBatteryManager<Bus>::read_data() {
   data.voltage = read_smbus_word(SBS_CMD_VOLTAGE);
   data.current = (int16_t)read_smbus_word(SBS_CMD_CURRENT);
   data.relative_state_of_charge = read_smbus_word(SBS_CMD_RELATIVE_SOC);
@@ -82,7 +93,26 @@ bool BatteryManager::read_data() {
   return true;
 }
 
-void BatteryManager::generate_demo_data(int state) {
+template <class Bus>
+bool BasicBatteryManager<Bus>::read_live_data() {
+  // Every word must read, or a failed Current() would pass as -1 mA.
+  uint16_t current;
+  if (!bus.read_word(SMBUS_ADDRESS, SBS_CMD_VOLTAGE, data.voltage) ||
+      !bus.read_word(SMBUS_ADDRESS, SBS_CMD_CURRENT, current) ||
+      !bus.read_word(SMBUS_ADDRESS, SBS_CMD_RELATIVE_SOC, data.relative_state_of_charge) ||
+      !bus.read_word(SMBUS_ADDRESS, SBS_CMD_BATTERY_STATUS, data.battery_status_word)) {
+    data.error_condition = true;
+    return false;
+  }
+  data.current = (int16_t)current;
+
+  parse_status_flags(data.battery_status_word);
+  return true;
+}
+
+template <class Bus>
+void BasicBatteryManager<Bus>::reset_demo_data() {
+  data = BatteryData();
   data.manufacturer_name = "DEMO INC.";
   data.device_name = "DEMO-BATT";
   data.chemistry = "LION";
@@ -91,83 +121,78 @@ void BatteryManager::generate_demo_data(int state) {
   data.manufacture_date = (2023-1980)*512 + 10*32 + 26;
   data.serial_number = 12345;
   data.specification_info = 33;
-  data.cycle_count = 10;
-  data.charging_current = 1500;
+  data.charging_current = 2000;
   data.charging_voltage = 12600;
-  data.error_condition = false;
-  data.fully_charged = false;
-  data.fully_discharged = false;
-
-  if (state == 0) {
-    data.relative_state_of_charge = max(0, data.relative_state_of_charge - 5);
-    data.current = -1500;
-    if (data.relative_state_of_charge <= 5) data.fully_discharged = true;
-  } else if (state == 1) {
-    data.relative_state_of_charge = min(100, data.relative_state_of_charge + 5);
-    data.current = 2000;
-    if (data.relative_state_of_charge >= 99) data.fully_charged = true;
-  } else {
-    data.current = 0;
-  }
-  
-  data.absolute_state_of_charge = data.relative_state_of_charge;
-  data.remaining_capacity = (uint16_t)(5000L * data.relative_state_of_charge / 100);
-  data.full_charge_capacity = 5000;
-  data.voltage = 10000 + (25 * data.relative_state_of_charge);
-  data.temperature = 2982 + random(0, 50);
-  data.cell_voltage_1 = data.voltage/3;
-  data.cell_voltage_2 = data.voltage/3;
-  data.cell_voltage_3 = data.voltage/3;
+  demo_pack.reset();
+  demo_last_update = millis();
+  generate_demo_data(PackModel::REST);
+}
+
+template <class Bus>
+void BasicBatteryManager<Bus>::generate_demo_data(int state) {
+  unsigned long now = millis();
+  demo_pack.step((now - demo_last_update) * DEMO_TIME_MULTIPLIER, state);
+  demo_last_update = now;
+
+  data.voltage = demo_pack.voltage_mv();
+  data.current = demo_pack.current_ma();
+  data.relative_state_of_charge = demo_pack.relative_state_of_charge();
+  data.remaining_capacity = demo_pack.remaining_capacity_mah();
+  data.full_charge_capacity = demo_pack.full_charge_capacity_mah();
+  data.absolute_state_of_charge = (uint16_t)(data.remaining_capacity * 100L / data.design_capacity);
+  data.temperature = demo_pack.temperature_dk();
+  data.cycle_count = demo_pack.cycle_count();
+  data.cell_voltage_1 = demo_pack.cell_voltage_mv(0);
+  data.cell_voltage_2 = demo_pack.cell_voltage_mv(1);
+  data.cell_voltage_3 = demo_pack.cell_voltage_mv(2);
   data.cell_voltage_4 = 0;
-  data.state_of_health = 95;
+  data.state_of_health = (uint16_t)(data.full_charge_capacity * 100L / data.design_capacity);
+  data.battery_status_word = demo_pack.status_word();
+  parse_status_flags(data.battery_status_word);
 }
 
-const BatteryData& BatteryManager::get_data() const {
+template <class Bus>
+const BatteryData& BasicBatteryManager<Bus>::get_data() const {
   return data;
 }
 
-bool BatteryManager::is_fully_charged() const { return data.fully_charged; }
-bool BatteryManager::is_fully_discharged() const { return data.fully_discharged; }
-bool BatteryManager::is_charge_inhibited() const { return data.charge_fet_closed; }
-bool BatteryManager::is_discharge_inhibited() const { return data.discharge_fet_closed; }
-bool BatteryManager::has_error() const { return data.error_condition; }
+template <class Bus> bool BasicBatteryManager<Bus>::is_fully_charged() const { return data.fully_charged; }
+template <class Bus> bool BasicBatteryManager<Bus>::is_fully_discharged() const { return data.fully_discharged; }
+template <class Bus> bool BasicBatteryManager<Bus>::is_charge_inhibited() const { return data.charge_fet_closed; }
+template <class Bus> bool BasicBatteryManager<Bus>::is_discharge_inhibited() const { return data.discharge_fet_closed; }
+template <class Bus> bool BasicBatteryManager<Bus>::has_error() const { return data.error_condition; }
 
-uint16_t BatteryManager::read_smbus_word(byte command) {
+template <class Bus>
+uint16_t BasicBatteryManager<Bus>::read_smbus_word(byte command) {
   uint16_t result = 0xFFFF;
-  Wire.beginTransmission(SMBUS_ADDRESS);
-  Wire.write(command);
-  if (Wire.endTransmission(false) != 0) return result;
-  if (Wire.requestFrom(SMBUS_ADDRESS, (byte)2) == 2) {
-    byte lowByte = Wire.read();
-    byte highByte = Wire.read();
-    result = (uint16_t)highByte << 8 | lowByte;
-  }
+  bus.read_word(SMBUS_ADDRESS, command, result);
   return result;
 }
 
-String BatteryManager::read_smbus_string(byte command) {
+template <class Bus>
+String BasicBatteryManager<Bus>::read_smbus_string(byte command) {
   char buffer[32];
-  memset(buffer, 0, sizeof(buffer));
-  
-  Wire.beginTransmission(SMBUS_ADDRESS);
-  Wire.write(command);
-  if (Wire.endTransmission(false) != 0) return "READ_ERR";
-
-  byte len = 0;
-  if (Wire.requestFrom(SMBUS_ADDRESS, (byte)32, (byte)true) > 0) {
-    len = Wire.read();
-    if (len > 31) len = 31;
-    for (byte i = 0; i < len; i++) {
-      buffer[i] = Wire.read();
-    }
-  }
+  if (!bus.read_block(SMBUS_ADDRESS, command, buffer, sizeof(buffer))) return "READ_ERR";
   return String(buffer);
 }
 
-void BatteryManager::parse_status_flags(uint16_t status_word) {
+template <class Bus>
+void BasicBatteryManager<Bus>::parse_status_flags(uint16_t status_word) {
   data.error_condition = (status_word & 0x8000) != 0;
   data.fully_charged = (status_word & 0x0020) != 0;
   data.fully_discharged = (status_word & 0x0010) != 0;
   data.charge_fet_closed = data.fully_charged;
   data.discharge_fet_closed = data.fully_discharged;
 }
+
+#if SMBUS_BACKEND == SMBUS_BACKEND_MOCK
+template class BasicBatteryManager<MockBus>;
+#else
+// The benchmark needs every device backend; otherwise only the selected one is built.
+#if SMBUS_BACKEND == SMBUS_BACKEND_TWI || BUS_BENCHMARK
+template class BasicBatteryManager<TwiBus>;
+#endif
+#if SMBUS_BACKEND == SMBUS_BACKEND_SOFTWIRE || BUS_BENCHMARK
+template class BasicBatteryManager<SoftWireBus<SOFTWIRE_SDA_PIN, SOFTWIRE_SCL_PIN> >;
+#endif
+#endif
@@ -2,7 +2,15 @@
 #define BATTERY_MANAGER_H
 
 #include <Arduino.h>
-#include <Wire.h>
+#include "config.h"
+#include "pack_model.h"
+
+#if SMBUS_BACKEND == SMBUS_BACKEND_MOCK
+#include "smbus_mock.h"
+#else
+#include "smbus_twi.h"
+#include "smbus_softwire.h"
+#endif
 
 struct BatteryData {
   String manufacturer_name;
@@ -36,11 +44,21 @@ struct BatteryData {
   bool error_condition;
 };
 
-class BatteryManager {
+// Copies the cell voltages that hold a reading into cells[] and returns how
+// many there are. Unpopulated slots read 0, and a gauge that NACKs the
+// optional cell commands leaves them at 0xFFFF.
+uint8_t valid_cell_voltages(const BatteryData& data, uint16_t cells[4]);
+
+// Bus is an SMBus backend (TwiBus, SoftWireBus, MockBus) providing begin(),
+// probe(), read_word() and read_block(); calls are resolved at compile time.
+template <class Bus>
+class BasicBatteryManager {
 public:
-  BatteryManager();
+  BasicBatteryManager();
   bool connect();
   bool read_data();
+  bool read_live_data();
+  void reset_demo_data();
   void generate_demo_data(int state);
   const BatteryData& get_data() const;
   bool is_fully_charged() const;
@@ -50,10 +68,21 @@ public:
   bool has_error() const;
 
 private:
+  Bus bus;
   BatteryData data;
+  PackModel demo_pack;
+  unsigned long demo_last_update;
   uint16_t read_smbus_word(byte command);
   String read_smbus_string(byte command);
   void parse_status_flags(uint16_t status_word);
 };
 
+#if SMBUS_BACKEND == SMBUS_BACKEND_MOCK
+typedef BasicBatteryManager<MockBus> BatteryManager;
+#elif SMBUS_BACKEND == SMBUS_BACKEND_SOFTWIRE
+typedef BasicBatteryManager<SoftWireBus<SOFTWIRE_SDA_PIN, SOFTWIRE_SCL_PIN> > BatteryManager;
+#else
+typedef BasicBatteryManager<TwiBus> BatteryManager;
+#endif
+
 #endif // BATTERY_MANAGER_H
@@ -3,6 +3,8 @@
 
 static String parse_manufacture_date(uint16_t date_word);
 static void print_detailed_status_flags(uint16_t status_word);
+static const __FlashStringHelper* phase_end_name(PhaseEnd end, bool charging);
+static String pad(const String& text, unsigned int width);
 
 void reporter_print_data(const BatteryData& data, bool full_report) {
   if (full_report) {
@@ -44,6 +46,50 @@ void reporter_print_data(const BatteryData& data, bool full_report) {
   print_detailed_status_flags(data.battery_status_word);
 }
 
+void reporter_print_cycle_record(int cycle, const CycleRecord& record) {
+  ui_print_message(String(F("\n  --- Cycle ")) + cycle + F(" Result ---"));
+  ui_print_param(F("Full Charge Capacity (mAh) "), String(record.fcc_before) + " -> " + String(record.fcc_after));
+  ui_print_param(F("Discharged (mAh)           "), String(record.discharged_mah));
+  ui_print_param(F("Cycle Count                "), String(record.cycle_count_before) + " -> " + String(record.cycle_count_after));
+  ui_print_param(F("State of Health (%)        "), String(record.soh_before) + " -> " + String(record.soh_after));
+  ui_print_param(F("Discharge (min) / Ended By "), String(record.discharge_minutes) + " / " + phase_end_name(record.discharge_end, false));
+  ui_print_param(F("Charge (min) / Ended By    "), String(record.charge_minutes) + " / " + phase_end_name(record.charge_end, true));
+  ui_print_param(F("Peak Temp (C)              "), String(record.peak_temperature / 10.0 - 273.15, 1));
+  ui_print_param(F("Max Cell Imbalance (mV)    "), String(record.max_cell_imbalance_mv));
+}
+
+void reporter_print_cycle_summary(const CycleRecord* records, int count) {
+  ui_print_message(F("\n  ===== CALIBRATION SUMMARY ====="));
+  ui_print_message(F("  Cyc  FCC before  FCC after  Dsg mAh  CC     SoH  Dsg min  End  Chg min  End  Tmax C  dV mV"));
+  for (int i = 0; i < count; i++) {
+    const CycleRecord& r = records[i];
+    ui_print_message(String(F("  ")) + pad(String(i + 1), 5)
+                     + pad(String(r.fcc_before), 12) + pad(String(r.fcc_after), 11)
+                     + pad(String(r.discharged_mah), 9) + pad(String(r.cycle_count_after), 7)
+                     + pad(String(r.soh_after), 5) + pad(String(r.discharge_minutes), 9)
+                     + pad(phase_end_name(r.discharge_end, false), 5) + pad(String(r.charge_minutes), 9)
+                     + pad(phase_end_name(r.charge_end, true), 5)
+                     + pad(String(r.peak_temperature / 10.0 - 273.15, 1), 8) + String(r.max_cell_imbalance_mv));
+  }
+  ui_print_message(F("  =================================="));
+}
+
+static const __FlashStringHelper* phase_end_name(PhaseEnd end, bool charging) {
+  switch (end) {
+    case PhaseEnd::FLAG:          return charging ? F("FC") : F("FD");
+    case PhaseEnd::FET_INHIBIT:   return F("FET");
+    case PhaseEnd::BATTERY_ERROR: return F("ERR");
+    case PhaseEnd::ABORTED:       return F("ABT");
+  }
+  return F("?");
+}
+
+static String pad(const String& text, unsigned int width) {
+  String result = text;
+  while (result.length() < width) result += ' ';
+  return result;
+}
+
 static String parse_manufacture_date(uint16_t date_word) {
   int day = date_word & 0x1F;
   int month = (date_word >> 5) & 0x0F;
@@ -2,7 +2,10 @@
 #define BATTERY_REPORTER_H
 
 #include "battery_manager.h"
+#include "cycle_record.h"
 
 void reporter_print_data(const BatteryData& data, bool full_report);
+void reporter_print_cycle_record(int cycle, const CycleRecord& record);
+void reporter_print_cycle_summary(const CycleRecord* records, int count);
 
 #endif // BATTERY_REPORTER_H
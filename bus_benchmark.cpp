@@ -0,0 +1,36 @@
+#include "bus_benchmark.h"
+#include "battery_manager.h"
+#include "user_interface.h"
+#include "config.h"
+
+#if BUS_BENCHMARK
+
+template <class Manager>
+static void benchmark_backend(const __FlashStringHelper* name, Manager& manager) {
+  if (!manager.connect()) {
+    ui_print_param(name, F("no battery on this bus"));
+    return;
+  }
+  int failed = 0;
+  unsigned long started = micros();
+  for (int i = 0; i < BUS_BENCHMARK_READS; i++) {
+    if (!manager.read_data()) failed++;
+  }
+  unsigned long per_read = (micros() - started) / BUS_BENCHMARK_READS;
+  ui_print_param(name, String(per_read) + F(" us per read_data, ") + failed + F(" failed"));
+}
+
+void bus_benchmark_run() {
+  ui_print_message(String(F("\n--- SMBus Backend Benchmark (")) + BUS_BENCHMARK_READS + F(" reads) ---"));
+  {
+    BasicBatteryManager<TwiBus> twi;
+    benchmark_backend(F("TWI (A4/A5)"), twi);
+    Wire.end(); // Release A4/A5 in case they are jumpered to the SoftWire pins
+  }
+  {
+    BasicBatteryManager<SoftWireBus<SOFTWIRE_SDA_PIN, SOFTWIRE_SCL_PIN> > softwire;
+    benchmark_backend(F("SoftWire   "), softwire);
+  }
+}
+
+#endif // BUS_BENCHMARK
@@ -0,0 +1,6 @@
+#ifndef BUS_BENCHMARK_H
+#define BUS_BENCHMARK_H
+
+void bus_benchmark_run();
+
+#endif // BUS_BENCHMARK_H
@@ -22,13 +22,47 @@ const unsigned long CALIBRATION_PRE_CHARGE_WAIT_MS = 1800000; // 30 minutes
 const unsigned long CALIBRATION_CHARGE_WAIT_MS = 3600000; // 1 hour
 const unsigned long CALIBRATION_DISCHARGE_WAIT_MS = 18000000; // 5 hours
 
+// --- Calibration Cycles ---
+const int MAX_CALIBRATION_CYCLES = 5;
+const int FCC_CONVERGENCE_TOLERANCE_PERCENT = 1; // End early once FCC moves less than this between cycles
+
+// --- SoH Estimation ---
+const unsigned long SOH_SAMPLE_INTERVAL_MS = 250;    // Fast sampling around the pulse
+const unsigned long SOH_REST_DURATION_MS = 300000;   // 5 minutes rest before the pulse and after counting
+const unsigned long SOH_PULSE_DURATION_MS = 10000;   // 10 seconds discharge pulse
+const unsigned long SOH_MAX_DURATION_MS = 3300000;   // 55 minutes hard limit, final rest included
+const unsigned long SOH_GAUGE_UPDATE_MS = 1000;      // Gauge refresh period of Voltage()/Current()
+const int SOH_PULSE_MIN_CURRENT_MA = 200;            // Minimum current step to detect the pulse
+const int SOH_STEP_SETTLE_MV = 10;                   // Pulse readings one update apart agree within this...
+const int SOH_STEP_SETTLE_MA = 50;                   // ...and this before the step is taken
+const int SOH_TARGET_SOC_DELTA = 20;                 // Approximate SoC span (%) to coulomb count across
+const int SOH_MIN_SOC_DELTA = 5;                     // Smallest OCV SoC span (%) giving an estimate
+const int SOH_OCV_ERROR_MV = 5;                      // Per-cell voltage reading and OCV table uncertainty
+const unsigned long SOH_RELAX_WINDOW_MS = 60000;     // Last part of each rest whose drift bounds the relaxation error
+
 // --- Demo Mode Timings ---
-const unsigned long DEMO_PROCESS_DURATION_MS = 3000; // 3 seconds
-const unsigned long DEMO_WAIT_DURATION_MS = 3000;    // 3 seconds
+// DEMO runs the pack model and the calibration waits this many times faster than real time.
+const unsigned long DEMO_TIME_MULTIPLIER = 360;
 
 // --- Battery Communication ---
 const int BATTERY_CONNECT_RETRIES = 3;
 
+// --- SMBus Backend (selected at compile time) ---
+#define SMBUS_BACKEND_TWI 0      // Hardware TWI on A4/A5 via Wire
+#define SMBUS_BACKEND_SOFTWIRE 1 // Bit-banged bus on SOFTWIRE_SDA_PIN/SOFTWIRE_SCL_PIN
+#define SMBUS_BACKEND_MOCK 2     // Simulated pack, host builds only (host/sim)
+#ifndef SMBUS_BACKEND
+#define SMBUS_BACKEND SMBUS_BACKEND_TWI
+#endif
+const int SOFTWIRE_SDA_PIN = 2;
+const int SOFTWIRE_SCL_PIN = 3;
+
+// Times read_data() on every device backend at startup (needs the pack wired to both buses).
+#ifndef BUS_BENCHMARK
+#define BUS_BENCHMARK 0
+#endif
+const int BUS_BENCHMARK_READS = 20;
+
 // --- Serial Communication ---
 const int SERIAL_BAUD_RATE = 9600;
 
@@ -0,0 +1,33 @@
+#ifndef CYCLE_RECORD_H
+#define CYCLE_RECORD_H
+
+#include <Arduino.h>
+
+// Which check ended a charge or discharge phase.
+enum class PhaseEnd : uint8_t {
+  FLAG,          // FC or FD reported by the gauge
+  FET_INHIBIT,   // Charge/discharge FET closed by the battery
+  BATTERY_ERROR,
+  ABORTED        // Process stopped before the phase ended (or before it began)
+};
+
+// Summary of one calibration cycle, captured when POST_CHARGE_WAIT ends, or
+// with whatever was reached if the process stops during the cycle.
+// Durations are in minutes of pack time (scaled in DEMO), temperature in 0.1 K.
+struct CycleRecord {
+  uint16_t fcc_before;
+  uint16_t fcc_after;
+  uint16_t discharged_mah;
+  uint16_t cycle_count_before;
+  uint16_t cycle_count_after;
+  uint16_t soh_before;
+  uint16_t soh_after;
+  uint16_t discharge_minutes;
+  uint16_t charge_minutes;
+  uint16_t peak_temperature;
+  uint16_t max_cell_imbalance_mv;
+  PhaseEnd discharge_end;
+  PhaseEnd charge_end;
+};
+
+#endif // CYCLE_RECORD_H
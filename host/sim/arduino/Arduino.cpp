@@ -0,0 +1,59 @@
+#include "Arduino.h"
+#include <stdio.h>
+
+thread_local HostContext* host_context = nullptr;
+HostSerial Serial;
+
+unsigned long millis() { return host_context->now_ms; }
+unsigned long micros() { return host_context->now_ms * 1000UL; }
+void delay(unsigned long ms) { host_context->now_ms += ms; }
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin < HOST_NUM_PINS) host_context->pins[pin] = value;
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < HOST_NUM_PINS ? host_context->pins[pin] : LOW;
+}
+
+long random(long min_value, long max_value) {
+  if (max_value <= min_value) return min_value;
+  std::uniform_int_distribution<long> dist(min_value, max_value - 1);
+  return dist(host_context->rng);
+}
+
+String::String(double value, unsigned char decimal_places) {
+  char buffer[48];
+  snprintf(buffer, sizeof(buffer), "%.*f", (int)decimal_places, value);
+  str_ = buffer;
+}
+
+void HostSerial::print(const String& text) {
+  for (char c : text.str()) print(c);
+}
+
+void HostSerial::print(char c) {
+  if (c == '\r') return;
+  if (c == '\n') {
+    if (host_context->console) host_context->console(host_context->console_line);
+    host_context->console_line.clear();
+    return;
+  }
+  host_context->console_line += c;
+}
+
+void HostSerial::println(const String& text) {
+  print(text);
+  print('\n');
+}
+
+void HostSerial::println(char c) {
+  print(c);
+  print('\n');
+}
+
+void HostSerial::println() {
+  print('\n');
+}
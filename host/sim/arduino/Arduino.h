@@ -0,0 +1,135 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Minimal host-side stand-in for the Arduino core, enough to build the
+// controller sources with g++. Every rig runs on its own thread, so the clock,
+// pins and console sink live in a thread-local HostContext.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <functional>
+#include <random>
+#include <string>
+#include <type_traits>
+
+// long is 32 bits on the AVR. The Makefile builds with -m32 so long and
+// millis() arithmetic wrap as on the Nano; M32=0 opts out. int stays 32 bits
+// either way, so 16-bit int overflow is not reproduced.
+#ifndef HOST_LONG_64BIT
+static_assert(sizeof(long) == 4, "build with -m32 (or M32=0 to accept 64-bit long)");
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+const int HOST_NUM_PINS = 32;
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+
+struct HostContext {
+  unsigned long now_ms = 0;
+  int pins[HOST_NUM_PINS] = {};
+  std::mt19937 rng;
+  std::function<void(const std::string&)> console;
+  std::string console_line;
+};
+
+extern thread_local HostContext* host_context;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+long random(long min_value, long max_value);
+
+inline bool isDigit(int c) { return isdigit(c) != 0; }
+
+template <class A, class B>
+inline typename std::common_type<A, B>::type min(A a, B b) { return a < b ? a : b; }
+template <class A, class B>
+inline typename std::common_type<A, B>::type max(A a, B b) { return a > b ? a : b; }
+template <class T, class L, class H>
+inline T constrain(T value, L low, H high) { return value < low ? low : (value > high ? high : value); }
+
+class String {
+public:
+  String(const char* s = "") : str_(s ? s : "") {}
+  String(const __FlashStringHelper* s) : str_(reinterpret_cast<const char*>(s)) {}
+  explicit String(const std::string& s) : str_(s) {}
+  explicit String(char c) : str_(1, c) {}
+  explicit String(unsigned char value) : str_(std::to_string(value)) {}
+  explicit String(int value) : str_(std::to_string(value)) {}
+  explicit String(unsigned int value) : str_(std::to_string(value)) {}
+  explicit String(long value) : str_(std::to_string(value)) {}
+  explicit String(unsigned long value) : str_(std::to_string(value)) {}
+  explicit String(double value, unsigned char decimal_places = 2);
+
+  unsigned int length() const { return (unsigned int)str_.size(); }
+  const char* c_str() const { return str_.c_str(); }
+  const std::string& str() const { return str_; }
+  long toInt() const { return atol(str_.c_str()); }
+  void remove(unsigned int index) { if (index < str_.size()) str_.erase(index); }
+  void remove(unsigned int index, unsigned int count) { if (index < str_.size()) str_.erase(index, count); }
+
+  String& operator+=(const String& rhs) { str_ += rhs.str_; return *this; }
+  String& operator+=(const char* rhs) { str_ += rhs; return *this; }
+  String& operator+=(char rhs) { str_ += rhs; return *this; }
+  bool operator==(const String& rhs) const { return str_ == rhs.str_; }
+  bool operator!=(const String& rhs) const { return str_ != rhs.str_; }
+
+private:
+  std::string str_;
+};
+
+inline String operator+(const String& lhs, const String& rhs) { String s(lhs); s += rhs; return s; }
+inline String operator+(const String& lhs, const char* rhs) { String s(lhs); s += rhs; return s; }
+inline String operator+(const String& lhs, const __FlashStringHelper* rhs) { return lhs + String(rhs); }
+inline String operator+(const String& lhs, char rhs) { String s(lhs); s += rhs; return s; }
+inline String operator+(const String& lhs, unsigned char rhs) { return lhs + String(rhs); }
+inline String operator+(const String& lhs, int rhs) { return lhs + String(rhs); }
+inline String operator+(const String& lhs, unsigned int rhs) { return lhs + String(rhs); }
+inline String operator+(const String& lhs, long rhs) { return lhs + String(rhs); }
+inline String operator+(const String& lhs, unsigned long rhs) { return lhs + String(rhs); }
+inline String operator+(const String& lhs, double rhs) { return lhs + String(rhs); }
+
+class HostSerial {
+public:
+  void begin(unsigned long) {}
+  explicit operator bool() const { return true; }
+  int available() { return 0; }
+  int read() { return -1; }
+  void print(const String& text);
+  void print(char c);
+  void print(int value) { print(String(value)); }
+  void print(unsigned int value) { print(String(value)); }
+  void print(long value) { print(String(value)); }
+  void print(unsigned long value) { print(String(value)); }
+  void println(const String& text);
+  void println(char c);
+  void println(int value) { println(String(value)); }
+  void println(unsigned int value) { println(String(value)); }
+  void println(long value) { println(String(value)); }
+  void println(unsigned long value) { println(String(value)); }
+  void println();
+};
+
+extern HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
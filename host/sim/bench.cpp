@@ -0,0 +1,33 @@
+#include "bench.h"
+#include "sim_battery.h"
+#include "battery_manager.h"
+
+#include <stdio.h>
+#include <chrono>
+
+void run_bus_benchmark(int reads, uint32_t seed) {
+  HostContext context;
+  context.rng.seed(seed);
+  host_context = &context;
+
+  PackProfile profile = make_pack_profile(0, seed);
+  profile.bus_fault_rate = 0;
+  SimBattery sim(profile, seed);
+  mock_bus_device = &sim;
+
+  BatteryManager battery;
+  battery.connect();
+
+  int failed = 0;
+  auto started = std::chrono::steady_clock::now();
+  for (int i = 0; i < reads; i++) {
+    if (!battery.read_data()) failed++;
+  }
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count();
+
+  printf("%-10s %8s %14s %8s\n", "backend", "reads", "us/read_data", "failed");
+  printf("%-10s %8d %14.2f %8d\n", "mock", reads, us / reads, failed);
+
+  mock_bus_device = nullptr;
+  host_context = nullptr;
+}
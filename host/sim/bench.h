@@ -0,0 +1,9 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+// Times BatteryManager::read_data() over the mock backend.
+void run_bus_benchmark(int reads, uint32_t seed);
+
+#endif // BENCH_H
@@ -0,0 +1,236 @@
+// Runs many independent virtual calibration rigs in parallel against the
+// simulated SBS pack and summarizes how the controller handled each class.
+
+#include "rig.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Options {
+  int rigs = 200;
+  int threads = 0;
+  int bench_reads = 0;
+  const char* csv_path = nullptr;
+  bool tick_set = false;
+  RigOptions rig = {5, false, false, false, 1, 1000, 400ULL * 3600000ULL, 2UL * 3600000UL};
+};
+
+struct ClassSummary {
+  int rigs = 0;
+  int completed = 0;
+  int converged = 0;
+  int cycles_run = 0;
+  int aborted = 0;
+  int timed_out = 0;
+  double completed_hours = 0;
+  double min_hours = 0;
+  double max_hours = 0;
+  int discharge_by_fd = 0;
+  int discharge_by_error = 0;
+  int discharge_other = 0;
+  int charge_by_fc = 0;
+  int charge_by_error = 0;
+  int charge_other = 0;
+  int read_errors = 0;
+  int soh_estimated = 0;
+  double soh_error_sum = 0;
+  double soh_abs_error_sum = 0;
+  double soh_min_error = 0;
+  double soh_max_error = 0;
+  int soh_confidence_sum = 0;
+};
+
+static void print_usage(const char* program) {
+  fprintf(stderr,
+          "Usage: %s [--rigs N] [--cycles N] [--threads N] [--seed N]\n"
+          "          [--tick-ms N] [--max-hours N] [--wrap-after-hours N] [--csv FILE]\n"
+          "          [--demo | --soh] [--log]\n"
+          "       %s --bench N\n", program, program);
+}
+
+static bool parse_options(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (!strcmp(arg, "--demo")) {
+      options.rig.demo = true;
+      continue;
+    }
+    if (!strcmp(arg, "--soh")) {
+      options.rig.soh = true;
+      continue;
+    }
+    if (!strcmp(arg, "--log")) {
+      options.rig.log = true;
+      continue;
+    }
+    if (!value) return false;
+    if (!strcmp(arg, "--rigs")) options.rigs = atoi(value);
+    else if (!strcmp(arg, "--cycles")) options.rig.cycles = atoi(value);
+    else if (!strcmp(arg, "--threads")) options.threads = atoi(value);
+    else if (!strcmp(arg, "--seed")) options.rig.seed = (uint32_t)strtoul(value, nullptr, 10);
+    else if (!strcmp(arg, "--tick-ms")) {
+      options.rig.tick_ms = strtoul(value, nullptr, 10);
+      options.tick_set = true;
+    }
+    else if (!strcmp(arg, "--max-hours")) options.rig.max_sim_ms = strtoull(value, nullptr, 10) * 3600000ULL;
+    else if (!strcmp(arg, "--wrap-after-hours")) {
+      unsigned long hours = strtoul(value, nullptr, 10);
+      if (hours == 0 || hours > 1000) return false; // Must fit below the 1193 h wrap
+      options.rig.wrap_after_ms = hours * 3600000UL;
+    }
+    else if (!strcmp(arg, "--csv")) options.csv_path = value;
+    else if (!strcmp(arg, "--bench")) options.bench_reads = atoi(value);
+    else return false;
+    i++;
+  }
+  // The SoH mode samples every SOH_SAMPLE_INTERVAL_MS, so tick at that rate.
+  if (options.rig.soh && !options.tick_set) options.rig.tick_ms = 250;
+  return !(options.rig.demo && options.rig.soh) && options.rigs > 0 && options.rig.cycles > 0 && options.rig.tick_ms > 0 && options.rig.max_sim_ms > 0;
+}
+
+static void print_calibration_table(const std::map<std::string, ClassSummary>& classes) {
+  printf("%-14s %5s %5s %5s %5s %5s %7s %8s %8s %8s  %-16s %-16s %7s\n",
+         "class", "rigs", "done", "conv", "abort", "t/out", "cyc/rig", "avg h", "min h", "max h",
+         "dsg FD/ERR/oth", "chg FC/ERR/oth", "rd err");
+  for (const auto& entry : classes) {
+    const ClassSummary& s = entry.second;
+    char dsg[24], chg[24];
+    snprintf(dsg, sizeof(dsg), "%d/%d/%d", s.discharge_by_fd, s.discharge_by_error, s.discharge_other);
+    snprintf(chg, sizeof(chg), "%d/%d/%d", s.charge_by_fc, s.charge_by_error, s.charge_other);
+    printf("%-14s %5d %5d %5d %5d %5d %7.2f %8.1f %8.1f %8.1f  %-16s %-16s %7d\n",
+           entry.first.c_str(), s.rigs, s.completed, s.converged, s.aborted, s.timed_out,
+           (double)s.cycles_run / s.rigs,
+           s.completed ? s.completed_hours / s.completed : 0.0, s.min_hours, s.max_hours,
+           dsg, chg, s.read_errors);
+}
+}
+
+// Estimated against the simulated pack's true capacity, in percent.
+static void print_soh_table(const std::map<std::string, ClassSummary>& classes) {
+  printf("%-14s %5s %5s %5s %8s %8s %8s %8s %6s %8s\n",
+         "class", "rigs", "done", "est", "mean %", "|err| %", "min %", "max %", "conf", "avg h");
+  for (const auto& entry : classes) {
+    const ClassSummary& s = entry.second;
+    int n = s.soh_estimated;
+    printf("%-14s %5d %5d %5d %8.2f %8.2f %8.2f %8.2f %6.1f %8.2f\n",
+           entry.first.c_str(), s.rigs, s.completed, n,
+           n ? s.soh_error_sum / n : 0.0, n ? s.soh_abs_error_sum / n : 0.0,
+           s.soh_min_error, s.soh_max_error, n ? (double)s.soh_confidence_sum / n : 0.0,
+           s.completed ? s.completed_hours / s.completed : 0.0);
+  }
+}
+
+static void write_csv(const char* path, const std::vector<RigOutcome>& outcomes) {
+  FILE* file = fopen(path, "w");
+  if (!file) {
+    perror(path);
+    return;
+  }
+  fprintf(file, "rig,class,sim_hours,completed,converged,cycles_run,aborted,timed_out,read_errors,"
+                "discharge_fd,discharge_error,discharge_other,charge_fc,charge_error,charge_other,"
+                "fcc_start,fcc_end,soh_true_mah,soh_estimate_mah,soh_confidence\n");
+  for (const RigOutcome& o : outcomes) {
+    fprintf(file, "%d,%s,%.3f,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%u,%u,%u,%u,%d\n",
+            o.index, o.label, o.sim_ms / 3600000.0, o.completed, o.converged, o.cycles_run,
+            o.aborted, o.timed_out, o.read_errors,
+            o.discharge_by_fd, o.discharge_by_error, o.discharge_other,
+            o.charge_by_fc, o.charge_by_error, o.charge_other, o.fcc_start, o.fcc_end,
+            o.soh_true_mah, o.soh_estimate_mah, o.soh_confidence);
+  }
+  fclose(file);
+}
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parse_options(argc, argv, options)) {
+    print_usage(argv[0]);
+    return 2;
+  }
+#ifdef HOST_LONG_64BIT
+  fprintf(stderr, "warning: 64-bit long build, millis() wrap and 32-bit overflow are not reproduced\n");
+#endif
+
+  if (options.bench_reads > 0) {
+    run_bus_benchmark(options.bench_reads, options.rig.seed);
+    return 0;
+  }
+
+  int threads = options.threads > 0 ? options.threads : (int)std::thread::hardware_concurrency();
+  if (threads <= 0) threads = 1;
+
+  std::vector<RigOutcome> outcomes(options.rigs);
+  std::atomic<int> next_rig(0);
+  auto started = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&]() {
+      for (int i = next_rig++; i < options.rigs; i = next_rig++) {
+        outcomes[i] = run_rig(i, options.rig);
+      }
+    });
+  }
+  for (std::thread& worker : workers) worker.join();
+
+  double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+  std::map<std::string, ClassSummary> classes;
+  double total_sim_hours = 0;
+  for (const RigOutcome& o : outcomes) {
+    double hours = o.sim_ms / 3600000.0;
+    total_sim_hours += hours;
+    ClassSummary& s = classes[o.label];
+    s.rigs++;
+    s.converged += o.converged;
+    s.cycles_run += o.cycles_run;
+    s.aborted += o.aborted;
+    s.timed_out += o.timed_out;
+    if (o.completed) {
+      s.min_hours = (s.completed == 0 || hours < s.min_hours) ? hours : s.min_hours;
+      s.max_hours = (s.completed == 0 || hours > s.max_hours) ? hours : s.max_hours;
+      s.completed_hours += hours;
+      s.completed++;
+    }
+    s.discharge_by_fd += o.discharge_by_fd;
+    s.discharge_by_error += o.discharge_by_error;
+    s.discharge_other += o.discharge_other;
+    s.charge_by_fc += o.charge_by_fc;
+    s.charge_by_error += o.charge_by_error;
+    s.charge_other += o.charge_other;
+    s.read_errors += o.read_errors;
+    if (o.soh_estimated) {
+      double error = 100.0 * ((double)o.soh_estimate_mah - o.soh_true_mah) / o.soh_true_mah;
+      s.soh_min_error = (s.soh_estimated == 0 || error < s.soh_min_error) ? error : s.soh_min_error;
+      s.soh_max_error = (s.soh_estimated == 0 || error > s.soh_max_error) ? error : s.soh_max_error;
+      s.soh_error_sum += error;
+      s.soh_abs_error_sum += error < 0 ? -error : error;
+      s.soh_confidence_sum += o.soh_confidence;
+      s.soh_estimated++;
+    }
+  }
+
+  if (options.rig.soh) {
+    printf("%d rigs, SoH estimate, %d threads, seed %u, tick %lu ms\n\n",
+           options.rigs, threads, options.rig.seed, options.rig.tick_ms);
+    print_soh_table(classes);
+  } else {
+    printf("%d rigs x %d cycles, %d threads, seed %u, tick %lu ms\n\n",
+           options.rigs, options.rig.cycles, threads, options.rig.seed, options.rig.tick_ms);
+    print_calibration_table(classes);
+  }
+
+  printf("\nSimulated %.1f rig-hours in %.2f s: %.1f rig-hours per wall-second\n",
+         total_sim_hours, wall_s, wall_s > 0 ? total_sim_hours / wall_s : 0.0);
+
+  if (options.csv_path) write_csv(options.csv_path, outcomes);
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include "rig.h"
+#include "sim_battery.h"
+#include "battery_manager.h"
+#include "process_controller.h"
+#include "config.h"
+#include "process_messages.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static bool contains(const std::string& line, const char* text) {
+  return line.find(text) != std::string::npos;
+}
+
+// Value of a "  key: value" line printed by ui_print_param.
+static long param_value(const std::string& line) {
+  size_t colon = line.find(": ");
+  return colon == std::string::npos ? 0 : atol(line.c_str() + colon + 2);
+}
+
+RigOutcome run_rig(int index, const RigOptions& options) {
+  HostContext context;
+  context.rng.seed(options.seed + (uint32_t)index);
+  // Start close to the 32-bit wrap so every run crosses it, as a Nano does
+  // after 49.7 days of uptime.
+  context.now_ms = (unsigned long)(0x100000000ULL - options.wrap_after_ms);
+  uint64_t elapsed_ms = 0;
+  host_context = &context;
+
+  PackProfile profile = make_pack_profile(index, options.seed);
+  SimBattery sim(profile, options.seed ^ (uint32_t)(index * 7919));
+  mock_bus_device = &sim;
+
+  RigOutcome outcome = RigOutcome();
+  outcome.index = index;
+  outcome.label = options.demo ? "demo" : profile.label;
+  outcome.fcc_start = sim.full_charge_capacity();
+  outcome.soh_true_mah = profile.true_capacity_mah;
+
+  BatteryManager battery;
+  ProcessController controller(battery);
+
+  context.console = [&](const std::string& line) {
+    if (options.log) printf("[rig %d %7.2fh] %s\n", index, elapsed_ms / 3600000.0, line.c_str());
+    const BatteryData& data = battery.get_data();
+    if (contains(line, MSG_DISCHARGE_PHASE_COMPLETE)) {
+      if (data.error_condition) outcome.discharge_by_error++;
+      else if (data.fully_discharged) outcome.discharge_by_fd++;
+      else outcome.discharge_other++;
+      outcome.cycles_run++;
+    } else if (contains(line, MSG_INITIAL_CHARGE_COMPLETE) || contains(line, MSG_CHARGE_PHASE_COMPLETE)) {
+      if (data.error_condition) outcome.charge_by_error++;
+      else if (data.fully_charged) outcome.charge_by_fc++;
+      else outcome.charge_other++;
+    } else if (contains(line, MSG_READ_ERROR)) {
+      outcome.read_errors++;
+    } else if (contains(line, MSG_READ_ERROR_ABORT)) {
+      outcome.aborted = true;
+    } else if (contains(line, MSG_ALL_CYCLES_COMPLETE)) {
+      outcome.completed = true;
+    } else if (contains(line, MSG_FCC_CONVERGED)) {
+      outcome.completed = true;
+      outcome.converged = true;
+    } else if (contains(line, MSG_SOH_FINISHED)) {
+      outcome.completed = true;
+    } else if (contains(line, MSG_SOH_CAPACITY)) {
+      outcome.soh_estimated = true;
+      outcome.soh_estimate_mah = (uint16_t)param_value(line);
+    } else if (contains(line, MSG_SOH_CONFIDENCE)) {
+      outcome.soh_confidence = (int)param_value(line);
+    }
+  };
+
+  controller.init();
+  battery.connect();
+  if (options.demo) controller.start_demo(options.cycles);
+  else if (options.soh) controller.start_soh_estimate();
+  else controller.start_calibration(options.cycles);
+
+  while (controller.is_busy()) {
+    if (elapsed_ms >= options.max_sim_ms) {
+      outcome.timed_out = true;
+      break;
+    }
+    controller.update();
+    sim.step(options.tick_ms,
+             context.pins[RELAY_PIN_CHARGE] == RELAY_ON,
+             context.pins[RELAY_PIN_DISCHARGE] == RELAY_ON);
+    context.now_ms += options.tick_ms;
+    elapsed_ms += options.tick_ms;
+  }
+
+  outcome.sim_ms = elapsed_ms;
+  outcome.fcc_end = sim.full_charge_capacity();
+  mock_bus_device = nullptr;
+  host_context = nullptr;
+  return outcome;
+}
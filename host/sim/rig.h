@@ -0,0 +1,45 @@
+#ifndef RIG_H
+#define RIG_H
+
+#include <stdint.h>
+
+struct RigOptions {
+  int cycles;
+  bool demo;
+  bool soh;
+  bool log;
+  uint32_t seed;
+  unsigned long tick_ms;
+  uint64_t max_sim_ms;
+  uint32_t wrap_after_ms; // Virtual millis() starts this long before it wraps
+};
+
+// What one virtual rig did, as seen through the controller's console output
+// and the flags it was acting on at the time.
+struct RigOutcome {
+  int index;
+  const char* label;
+  uint64_t sim_ms;
+  bool completed;
+  bool converged;
+  int cycles_run;
+  bool aborted;
+  bool timed_out;
+  int read_errors;
+  int discharge_by_fd;
+  int discharge_by_error;
+  int discharge_other;
+  int charge_by_fc;
+  int charge_by_error;
+  int charge_other;
+  uint16_t fcc_start;
+  uint16_t fcc_end;
+  bool soh_estimated;
+  uint16_t soh_true_mah;
+  uint16_t soh_estimate_mah;
+  int soh_confidence;
+};
+
+RigOutcome run_rig(int index, const RigOptions& options);
+
+#endif // RIG_H
@@ -0,0 +1,226 @@
+#include "sim_battery.h"
+#include "ocv_table.h"
+#include <math.h>
+
+namespace {
+
+const uint8_t SIM_SMBUS_ADDRESS = 0x0B;
+const double AMBIENT_C = 25.0;
+const double THERMAL_MASS_J_PER_C = 600.0;
+const double THERMAL_LOSS_W_PER_C = 0.25;
+const double CELL_CHARGE_LIMIT_MV = 4200.0;
+const double CELL_CUT_OFF_MV = 3000.0;
+
+
+double uniform(std::mt19937& rng, double lo, double hi) {
+  return std::uniform_real_distribution<double>(lo, hi)(rng);
+}
+
+} // namespace
+
+PackProfile make_pack_profile(int rig_index, uint32_t seed) {
+  std::mt19937 rng(seed * 2654435761u + (uint32_t)rig_index);
+  PackProfile p;
+  p.design_capacity_mah = (uint16_t)(2000 + 500 * (int)uniform(rng, 0, 9));
+  p.cells = uniform(rng, 0, 1) < 0.7 ? 3 : 4;
+  p.charge_current_ma = (uint16_t)uniform(rng, 1000, 3000);
+  p.discharge_current_ma = (uint16_t)uniform(rng, 1500, 3500);
+  p.cycle_count = (uint16_t)uniform(rng, 0, 600);
+  p.initial_soc = uniform(rng, 0.1, 0.9);
+  p.fd_latency_ms = 0;
+  p.bus_fault_rate = 0;
+  p.fc_never_set = false;
+
+  double health = uniform(rng, 0.85, 1.0);
+  double gauge_error = uniform(rng, -0.03, 0.03);
+  p.r0_mohm = (uint16_t)uniform(rng, 60, 120);
+
+  double pick = uniform(rng, 0, 1);
+  if (pick < 0.40) {
+    p.label = "healthy";
+  } else if (pick < 0.60) {
+    p.label = "aged";
+    health = uniform(rng, 0.55, 0.85);
+    p.r0_mohm = (uint16_t)uniform(rng, 150, 350);
+  } else if (pick < 0.75) {
+    p.label = "miscalibrated";
+    gauge_error = uniform(rng, -0.25, 0.25);
+  } else if (pick < 0.85) {
+    p.label = "slow-fd";
+    p.fd_latency_ms = (unsigned long)uniform(rng, 300000, 1800000);
+  } else if (pick < 0.95) {
+    p.label = "flaky-bus";
+    p.bus_fault_rate = uniform(rng, 0.02, 0.15);
+  } else {
+    p.label = "stuck-fc";
+    p.fc_never_set = true;
+  }
+
+  // Gauges differ on unpopulated cell slots: some report 0, some NACK them,
+  // and some implement none of the optional cell voltage commands.
+  double cell_pick = uniform(rng, 0, 1);
+  p.cell_commands = cell_pick < 0.6 ? 4 : cell_pick < 0.8 ? p.cells : 0;
+
+  // Voltage relaxation after a load is dominated by a slow branch of a few
+  // tens of mOhm with a time constant of minutes.
+  p.r1_mohm = (uint16_t)(p.r0_mohm * uniform(rng, 0.3, 0.6));
+  p.tau1_ms = (unsigned long)uniform(rng, 60000, 300000);
+
+  p.true_capacity_mah = (uint16_t)(p.design_capacity_mah * health);
+  p.learned_fcc_mah = (uint16_t)(p.true_capacity_mah * (1.0 + gauge_error));
+  return p;
+}
+
+SimBattery::SimBattery(const PackProfile& pack, uint32_t seed)
+    : profile(pack), rng(seed) {
+  soc = profile.initial_soc;
+  current_ma = 0;
+  polarization_mv = 0;
+  temperature_c = AMBIENT_C;
+  discharged_mah = 0;
+  started_full = false;
+  fully_charged = false;
+  fully_discharged = false;
+  cut_off = false;
+  cut_off_ms = 0;
+  learned_fcc_mah = profile.learned_fcc_mah;
+  cycle_count = profile.cycle_count;
+}
+
+double SimBattery::cell_ocv_mv() const {
+  return ocv_cell_mv((int16_t)lround(soc * 1000));
+}
+
+uint16_t SimBattery::terminal_voltage_mv() const {
+  return (uint16_t)(profile.cells * cell_ocv_mv() + current_ma * profile.r0_mohm / 1000.0 + polarization_mv);
+}
+
+void SimBattery::step(unsigned long dt_ms, bool charge_on, bool discharge_on) {
+  double pack_ocv = profile.cells * cell_ocv_mv() + polarization_mv; // Behind R0
+  double r_ohm = profile.r0_mohm / 1000.0;
+
+  if (discharge_on && !cut_off) {
+    current_ma = -(double)profile.discharge_current_ma;
+    if ((pack_ocv + current_ma * r_ohm) / profile.cells <= CELL_CUT_OFF_MV || soc <= 0) {
+      cut_off = true;
+      cut_off_ms = 0;
+      current_ma = 0;
+    }
+  } else if (charge_on && !discharge_on) {
+    // CC until the terminal voltage reaches the limit, then CV taper.
+    double v_limit = CELL_CHARGE_LIMIT_MV * profile.cells;
+    current_ma = profile.charge_current_ma;
+    if (pack_ocv + current_ma * r_ohm > v_limit) current_ma = max(0.0, (v_limit - pack_ocv) / r_ohm);
+    if (!profile.fc_never_set && soc > 0.95 && current_ma < profile.design_capacity_mah / 20.0) {
+      if (!fully_charged) {
+        started_full = true;
+        discharged_mah = 0;
+      }
+      fully_charged = true;
+    }
+  } else {
+    current_ma = 0;
+  }
+
+  // Exact first-order step, so long ticks stay stable.
+  double target_mv = current_ma * profile.r1_mohm / 1000.0;
+  polarization_mv = target_mv + (polarization_mv - target_mv) * exp(-(double)dt_ms / profile.tau1_ms);
+
+  double dt_h = dt_ms / 3600000.0;
+  soc = constrain(soc + current_ma * dt_h / profile.true_capacity_mah, 0.0, 1.0);
+  if (current_ma < 0) discharged_mah -= current_ma * dt_h;
+  if (current_ma > 0) cut_off = false;
+
+  if (cut_off && !fully_discharged) {
+    cut_off_ms += dt_ms;
+    if (cut_off_ms >= profile.fd_latency_ms) {
+      fully_discharged = true;
+      // A qualified FC -> FD discharge updates the learned capacity.
+      if (started_full) learned_fcc_mah = (uint16_t)discharged_mah;
+      started_full = false;
+      cycle_count++;
+    }
+  }
+  if (soc > 0.2) fully_discharged = false;
+  if (soc < 0.95) fully_charged = false;
+
+  double heat_w = (current_ma / 1000.0) * (current_ma / 1000.0) * r_ohm;
+  temperature_c += (heat_w - (temperature_c - AMBIENT_C) * THERMAL_LOSS_W_PER_C) * (dt_ms / 1000.0) / THERMAL_MASS_J_PER_C;
+}
+
+uint16_t SimBattery::status_word() const {
+  uint16_t status = 0x0080;
+  if (current_ma <= 0) status |= 0x0040;
+  if (fully_charged) status |= 0x0020 | 0x4000;
+  if (fully_discharged) status |= 0x0010 | 0x0800;
+  return status;
+}
+
+bool SimBattery::bus_fault() {
+  return profile.bus_fault_rate > 0 && uniform(rng, 0, 1) < profile.bus_fault_rate;
+}
+
+bool SimBattery::ack(uint8_t address) const {
+  return address == SIM_SMBUS_ADDRESS;
+}
+
+uint16_t SimBattery::read_word(uint8_t command) const {
+  // Like a real gauge, RM counts down from the learned FCC, so RSOC = RM / FCC
+  // drifts from the true SoC when FCC is out of calibration.
+  double used_mah = (1.0 - soc) * profile.true_capacity_mah;
+  uint16_t remaining = (uint16_t)constrain(lround(learned_fcc_mah - used_mah), 0L, (long)learned_fcc_mah);
+  uint16_t rsoc = learned_fcc_mah ? (uint16_t)(remaining * 100UL / learned_fcc_mah) : 0;
+  uint16_t cell_mv = (uint16_t)(terminal_voltage_mv() / profile.cells);
+  switch (command) {
+    case 0x08: return (uint16_t)lround((temperature_c + 273.15) * 10);
+    case 0x09: return terminal_voltage_mv();
+    case 0x0A: return (uint16_t)(int16_t)lround(current_ma);
+    case 0x0D: return rsoc;
+    case 0x0E: return (uint16_t)(remaining * 100UL / profile.design_capacity_mah);
+    case 0x0F: return remaining;
+    case 0x10: return learned_fcc_mah;
+    case 0x14: return profile.charge_current_ma;
+    case 0x15: return (uint16_t)(CELL_CHARGE_LIMIT_MV * profile.cells);
+    case 0x16: return status_word();
+    case 0x17: return cycle_count;
+    case 0x18: return profile.design_capacity_mah;
+    case 0x19: return (uint16_t)(3700 * profile.cells);
+    case 0x1A: return 0x0031;
+    case 0x1B: return (uint16_t)((2022 - 1980) * 512 + 6 * 32 + 1);
+    case 0x1C: return 4242;
+    case 0x3F: return cell_mv;
+    case 0x3E: return cell_mv;
+    case 0x3D: return cell_mv;
+    case 0x3C: return profile.cells > 3 ? cell_mv : 0;
+    default:   return 0xFFFF;
+  }
+}
+
+const char* SimBattery::read_string(uint8_t command) const {
+  switch (command) {
+    case 0x20: return "SIM";
+    case 0x21: return profile.label;
+    case 0x22: return "LION";
+    default:   return nullptr;
+  }
+}
+
+// A faulted transaction returns nothing. This is the only place a fault is
+// drawn, so each read fails at profile.bus_fault_rate.
+size_t SimBattery::read_command(uint8_t address, uint8_t command, uint8_t* buffer, size_t max_len) {
+  if (address != SIM_SMBUS_ADDRESS || bus_fault()) return 0;
+
+  const char* text = read_string(command);
+  if (text) {
+    size_t len = min(strlen(text), max_len - 1);
+    buffer[0] = (uint8_t)len;
+    memcpy(buffer + 1, text, len);
+    return len + 1;
+  }
+  if (max_len < 2) return 0;
+  if (command >= 0x3C && command <= 0x3F && 0x3F - command >= profile.cell_commands) return 0;
+  uint16_t word = read_word(command);
+  buffer[0] = word & 0xFF;
+  buffer[1] = word >> 8;
+  return 2;
+}
@@ -0,0 +1,65 @@
+#ifndef SIM_BATTERY_H
+#define SIM_BATTERY_H
+
+#include <Arduino.h>
+
+// Parameters of one simulated pack. Rigs draw these from a handful of
+// behavior classes so a run covers healthy packs as well as the awkward ones.
+struct PackProfile {
+  const char* label;
+  uint16_t design_capacity_mah;
+  uint16_t true_capacity_mah;
+  uint16_t learned_fcc_mah;
+  uint8_t cells;
+  uint16_t r0_mohm;
+  uint16_t r1_mohm;              // Slow polarization (diffusion) branch...
+  unsigned long tau1_ms;         // ...and its time constant
+  uint16_t charge_current_ma;
+  uint16_t discharge_current_ma;
+  uint16_t cycle_count;
+  double initial_soc;
+  unsigned long fd_latency_ms;
+  double bus_fault_rate;
+  bool fc_never_set;
+  uint8_t cell_commands;  // Cell voltage commands the gauge answers, from 0x3F down
+};
+
+PackProfile make_pack_profile(int rig_index, uint32_t seed);
+
+// Smart battery on the SMBus: a coarse electrical/thermal pack model plus the
+// gauge behavior the controller depends on (FC/FD flags, FCC learning).
+class SimBattery {
+public:
+  SimBattery(const PackProfile& profile, uint32_t seed);
+
+  void step(unsigned long dt_ms, bool charge_on, bool discharge_on);
+  uint16_t status_word() const;
+  uint16_t full_charge_capacity() const { return learned_fcc_mah; }
+
+  bool ack(uint8_t address) const;
+  size_t read_command(uint8_t address, uint8_t command, uint8_t* buffer, size_t max_len);
+
+private:
+  PackProfile profile;
+  std::mt19937 rng;
+  double soc;
+  double current_ma;
+  double polarization_mv;
+  double temperature_c;
+  double discharged_mah;
+  bool started_full;
+  bool fully_charged;
+  bool fully_discharged;
+  bool cut_off;
+  unsigned long cut_off_ms;
+  uint16_t learned_fcc_mah;
+  uint16_t cycle_count;
+
+  double cell_ocv_mv() const;
+  uint16_t terminal_voltage_mv() const;
+  uint16_t read_word(uint8_t command) const;
+  const char* read_string(uint8_t command) const;
+  bool bus_fault();
+};
+
+#endif // SIM_BATTERY_H
@@ -0,0 +1,29 @@
+#include "smbus_mock.h"
+#include "sim_battery.h"
+
+thread_local SimBattery* mock_bus_device = nullptr;
+
+uint8_t MockBus::probe(uint8_t address) {
+  // 2 is the AVR TWI driver's "NACK on address" code.
+  return (mock_bus_device && mock_bus_device->ack(address)) ? 0 : 2;
+}
+
+bool MockBus::read_word(uint8_t address, uint8_t command, uint16_t& value) {
+  uint8_t bytes[2];
+  if (!mock_bus_device || !mock_bus_device->ack(address)) return false;
+  if (mock_bus_device->read_command(address, command, bytes, sizeof(bytes)) != 2) return false;
+  value = (uint16_t)bytes[1] << 8 | bytes[0];
+  return true;
+}
+
+bool MockBus::read_block(uint8_t address, uint8_t command, char* buffer, uint8_t size) {
+  uint8_t bytes[33];
+  if (!mock_bus_device || !mock_bus_device->ack(address)) return false;
+  size_t received = mock_bus_device->read_command(address, command, bytes, sizeof(bytes));
+  if (received == 0) return false;
+  uint8_t len = min(bytes[0], (uint8_t)(size - 1));
+  len = min(len, (uint8_t)(received - 1));
+  memcpy(buffer, bytes + 1, len);
+  buffer[len] = '\0';
+  return true;
+}
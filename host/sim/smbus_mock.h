@@ -0,0 +1,21 @@
+#ifndef SMBUS_MOCK_H
+#define SMBUS_MOCK_H
+
+#include <Arduino.h>
+
+class SimBattery;
+
+// The simulated pack the current rig thread is talking to.
+extern thread_local SimBattery* mock_bus_device;
+
+// SMBus backend for host builds: transactions go straight to the rig's
+// SimBattery without any bus timing.
+class MockBus {
+public:
+  void begin() {}
+  uint8_t probe(uint8_t address);
+  bool read_word(uint8_t address, uint8_t command, uint16_t& value);
+  bool read_block(uint8_t address, uint8_t command, char* buffer, uint8_t size);
+};
+
+#endif // SMBUS_MOCK_H
@@ -0,0 +1,21 @@
+#include "ocv_table.h"
+
+const uint16_t OCV_TABLE_MV[] = {3000, 3450, 3580, 3650, 3700, 3760, 3830, 3920, 4010, 4100, 4200}; // 0..100 % in 10 % steps
+const uint8_t OCV_TABLE_LAST = sizeof(OCV_TABLE_MV) / sizeof(OCV_TABLE_MV[0]) - 1;
+
+uint16_t ocv_cell_mv(int16_t soc_permille) {
+  soc_permille = constrain(soc_permille, 0, 1000);
+  uint8_t k = soc_permille / 100;
+  if (k >= OCV_TABLE_LAST) return OCV_TABLE_MV[OCV_TABLE_LAST];
+  return OCV_TABLE_MV[k] + (int32_t)(OCV_TABLE_MV[k + 1] - OCV_TABLE_MV[k]) * (soc_permille - k * 100) / 100;
+}
+
+int16_t ocv_soc_permille(uint16_t cell_mv) {
+  if (cell_mv <= OCV_TABLE_MV[0]) return 0;
+  for (uint8_t k = 0; k < OCV_TABLE_LAST; k++) {
+    if (cell_mv <= OCV_TABLE_MV[k + 1]) {
+      return k * 100 + (int32_t)(cell_mv - OCV_TABLE_MV[k]) * 100 / (OCV_TABLE_MV[k + 1] - OCV_TABLE_MV[k]);
+    }
+  }
+  return 1000;
+}
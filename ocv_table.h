@@ -0,0 +1,11 @@
+#ifndef OCV_TABLE_H
+#define OCV_TABLE_H
+
+#include <Arduino.h>
+
+// Rested open-circuit voltage of one Li-ion cell versus state of charge,
+// shared by the SoH estimator and the demo pack model. SoC is in permille.
+uint16_t ocv_cell_mv(int16_t soc_permille);
+int16_t ocv_soc_permille(uint16_t cell_mv);
+
+#endif // OCV_TABLE_H
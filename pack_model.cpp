@@ -0,0 +1,153 @@
+#include "pack_model.h"
+#include "ocv_table.h"
+
+// --- Cell parameters ---
+const uint16_t CELL_CAPACITY_MAH[PACK_MODEL_CELLS] = {5000, 4940, 5060};
+const int16_t CELL_INITIAL_PERMILLE[PACK_MODEL_CELLS] = {500, 480, 515};
+const uint16_t CELL_R0_MOHM = 35;
+const uint16_t CELL_R1_MOHM = 25;
+const int32_t RC_TAU_MS = 60000;
+
+// --- Charger, load and gauge ---
+const int16_t CHARGE_CURRENT_MA = 2000;
+const int16_t DISCHARGE_CURRENT_MA = 1500;
+const int16_t TAPER_CUTOFF_MA = 100;
+const uint16_t CELL_CHARGE_LIMIT_MV = 4200;
+const uint16_t CELL_CUT_OFF_MV = 3000;
+const uint16_t INITIAL_FCC_MAH = 4500;  // Gauge starts out of calibration
+const uint16_t INITIAL_CYCLE_COUNT = 10;
+
+// --- Thermal ---
+const int32_t AMBIENT_UK = 298150000L;
+const int32_t THERMAL_MASS_J_PER_K = 300;
+const int32_t THERMAL_LOSS_MW_PER_K = 150;
+const int32_t OVER_TEMP_UK = 328150000L;  // 55 C
+
+const unsigned long MAX_SUBSTEP_MS = 1000;
+
+static int32_t cell_full_mas(uint8_t cell) {
+  return (int32_t)CELL_CAPACITY_MAH[cell] * 3600L;
+}
+
+void PackModel::reset() {
+  for (uint8_t i = 0; i < PACK_MODEL_CELLS; i++) {
+    cell_charge_mas[i] = (int32_t)CELL_CAPACITY_MAH[i] * 36L * CELL_INITIAL_PERMILLE[i] / 10;
+    cell_rc_uv[i] = 0;
+  }
+  charge_remainder = 0;
+  discharged_mas = 0;
+  temperature_uk = AMBIENT_UK;
+  current = 0;
+  learned_fcc_mah = INITIAL_FCC_MAH;
+  cycles = INITIAL_CYCLE_COUNT;
+  fully_charged = false;
+  fully_discharged = false;
+  full_discharge_qualified = false;
+}
+
+void PackModel::step(unsigned long dt_ms, int mode) {
+  while (dt_ms > 0) {
+    unsigned long dt = dt_ms < MAX_SUBSTEP_MS ? dt_ms : MAX_SUBSTEP_MS;
+    substep(dt, mode);
+    dt_ms -= dt;
+  }
+}
+
+void PackModel::substep(unsigned long dt_ms, int mode) {
+  if (mode == DISCHARGE && !fully_discharged) {
+    current = -DISCHARGE_CURRENT_MA;
+    for (uint8_t i = 0; i < PACK_MODEL_CELLS; i++) {
+      if (cell_terminal_mv(i, current) <= CELL_CUT_OFF_MV) {
+        // The weakest cell hit cut-off: the gauge sets FD and opens the discharge FET.
+        current = 0;
+        fully_discharged = true;
+        cycles++;
+        if (full_discharge_qualified) learned_fcc_mah = (uint16_t)(discharged_mas / 3600L);
+        full_discharge_qualified = false;
+        break;
+      }
+    }
+  } else if (mode == CHARGE) {
+    // Constant current until the pack reaches its voltage limit, then taper.
+    int32_t rc_mv = 0;
+    for (uint8_t i = 0; i < PACK_MODEL_CELLS; i++) rc_mv += cell_rc_uv[i] / 1000;
+    int32_t headroom_mv = (int32_t)CELL_CHARGE_LIMIT_MV * PACK_MODEL_CELLS - pack_ocv_mv() - rc_mv;
+    int32_t cv_limit_ma = headroom_mv * 1000L / (CELL_R0_MOHM * PACK_MODEL_CELLS);
+    current = (int16_t)constrain(cv_limit_ma, 0L, (long)CHARGE_CURRENT_MA);
+    if (current < TAPER_CUTOFF_MA && !fully_charged) {
+      fully_charged = true;
+      full_discharge_qualified = true;
+      discharged_mas = 0;
+    }
+  } else {
+    current = 0;
+  }
+
+  charge_remainder += (int32_t)current * (int32_t)dt_ms;
+  int32_t delta_mas = charge_remainder / 1000;
+  charge_remainder -= delta_mas * 1000;
+  if (delta_mas < 0) discharged_mas -= delta_mas;
+
+  int16_t min_permille = 1000;
+  for (uint8_t i = 0; i < PACK_MODEL_CELLS; i++) {
+    cell_charge_mas[i] = constrain(cell_charge_mas[i] + delta_mas, 0L, cell_full_mas(i));
+    int32_t target_uv = (int32_t)current * CELL_R1_MOHM;
+    cell_rc_uv[i] += (target_uv - cell_rc_uv[i]) * (int32_t)dt_ms / RC_TAU_MS;
+    int16_t permille = (int16_t)(cell_charge_mas[i] * 10L / (CELL_CAPACITY_MAH[i] * 36L));
+    if (permille < min_permille) min_permille = permille;
+  }
+
+  int32_t heat_mw = ((int32_t)current * current / 1000L) * (CELL_R0_MOHM * PACK_MODEL_CELLS) / 1000L;
+  int32_t loss_mw = (temperature_uk - AMBIENT_UK) / 1000L * THERMAL_LOSS_MW_PER_K / 1000L;
+  temperature_uk += (heat_mw - loss_mw) * (int32_t)dt_ms / THERMAL_MASS_J_PER_K;
+
+  if (min_permille < 950) fully_charged = false;
+  if (min_permille > 200) fully_discharged = false;
+}
+
+uint16_t PackModel::cell_ocv_mv(uint8_t cell) const {
+  return ocv_cell_mv((int16_t)(cell_charge_mas[cell] * 10L / (CELL_CAPACITY_MAH[cell] * 36L)));
+}
+
+int32_t PackModel::cell_terminal_mv(uint8_t cell, int16_t current_ma) const {
+  return (int32_t)cell_ocv_mv(cell) + (int32_t)current_ma * CELL_R0_MOHM / 1000L + cell_rc_uv[cell] / 1000L;
+}
+
+uint16_t PackModel::pack_ocv_mv() const {
+  uint16_t sum = 0;
+  for (uint8_t i = 0; i < PACK_MODEL_CELLS; i++) sum += cell_ocv_mv(i);
+  return sum;
+}
+
+uint16_t PackModel::voltage_mv() const {
+  int32_t sum = 0;
+  for (uint8_t i = 0; i < PACK_MODEL_CELLS; i++) sum += cell_terminal_mv(i, current);
+  return (uint16_t)sum;
+}
+
+uint16_t PackModel::cell_voltage_mv(uint8_t cell) const {
+  return cell < PACK_MODEL_CELLS ? (uint16_t)cell_terminal_mv(cell, current) : 0;
+}
+
+uint16_t PackModel::remaining_capacity_mah() const {
+  int32_t remaining = cell_charge_mas[0];
+  for (uint8_t i = 1; i < PACK_MODEL_CELLS; i++) {
+    if (cell_charge_mas[i] < remaining) remaining = cell_charge_mas[i];
+  }
+  return (uint16_t)(remaining / 3600L);
+}
+
+uint16_t PackModel::relative_state_of_charge() const {
+  if (learned_fcc_mah == 0) return 0;
+  uint32_t rsoc = ((uint32_t)remaining_capacity_mah() * 100UL + learned_fcc_mah / 2) / learned_fcc_mah;
+  return (uint16_t)min(rsoc, 100UL);
+}
+
+uint16_t PackModel::status_word() const {
+  uint16_t status = 0x0080;                          // INIT
+  if (current <= 0) status |= 0x0040;                // DSG
+  if (fully_charged) status |= 0x0020 | 0x4000;      // FC, TCA
+  if (fully_discharged) status |= 0x0010 | 0x0800;   // FD, TDA
+  if (temperature_uk >= OVER_TEMP_UK) status |= 0x1000; // OTA
+  return status;
+}
@@ -0,0 +1,49 @@
+#ifndef PACK_MODEL_H
+#define PACK_MODEL_H
+
+#include <Arduino.h>
+
+const uint8_t PACK_MODEL_CELLS = 3;
+
+// Lightweight fixed-point model of a 3S Li-ion pack behind a smart battery
+// gauge, used to feed DEMO mode. Each cell has its own capacity and charge
+// (imbalance), an OCV-vs-SoC curve, series resistance and one RC relaxation
+// pair; the pack has a single thermal mass. The gauge side sets FC/FD with
+// taper and cut-off and learns FCC on a full FC -> FD discharge.
+class PackModel {
+public:
+  enum Mode { DISCHARGE = 0, CHARGE = 1, REST = 2 };
+
+  void reset();
+  void step(unsigned long dt_ms, int mode);
+
+  uint16_t voltage_mv() const;
+  int16_t current_ma() const { return current; }
+  uint16_t cell_voltage_mv(uint8_t cell) const;
+  uint16_t remaining_capacity_mah() const;
+  uint16_t full_charge_capacity_mah() const { return learned_fcc_mah; }
+  uint16_t relative_state_of_charge() const;
+  uint16_t temperature_dk() const { return (uint16_t)((temperature_uk + 50000L) / 100000L); }
+  uint16_t cycle_count() const { return cycles; }
+  uint16_t status_word() const;
+
+private:
+  int32_t cell_charge_mas[PACK_MODEL_CELLS];
+  int32_t cell_rc_uv[PACK_MODEL_CELLS];
+  int32_t charge_remainder;
+  int32_t discharged_mas;
+  int32_t temperature_uk;
+  int16_t current;
+  uint16_t learned_fcc_mah;
+  uint16_t cycles;
+  bool fully_charged;
+  bool fully_discharged;
+  bool full_discharge_qualified;
+
+  uint16_t cell_ocv_mv(uint8_t cell) const;
+  int32_t cell_terminal_mv(uint8_t cell, int16_t current_ma) const;
+  uint16_t pack_ocv_mv() const;
+  void substep(unsigned long dt_ms, int mode);
+};
+
+#endif // PACK_MODEL_H
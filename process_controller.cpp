@@ -3,10 +3,14 @@
 #include "user_interface.h"
 #include "config.h"
 #include "battery_reporter.h"
+#include "ocv_table.h"
+#include "process_messages.h"
 
 ProcessController::ProcessController(BatteryManager& bat_manager) : battery(bat_manager) {
   current_process = Process::IDLE;
   consecutive_read_errors = 0;
+  charge_relay_on = false;
+  discharge_relay_on = false;
 }
 
 void ProcessController::init() {
@@ -21,6 +25,11 @@ bool ProcessController::is_busy() const {
 }
 
 void ProcessController::stop_process() {
+  if (current_process == Process::CALIBRATION || current_process == Process::DEMO) {
+    // A cycle cut short by an abort or read errors is the one most worth seeing.
+    if (calib_step >= CalibrationStep::DISCHARGING && cycle_record_count < current_cycle) record_aborted_cycle();
+    if (cycle_record_count > 0) reporter_print_cycle_summary(cycle_records, cycle_record_count);
+  }
   ui_print_message(F("\n# Process finished. Returning to menu."));
   control_relays(false, false);
   led_turn_off_all();
@@ -53,8 +62,9 @@ void ProcessController::start_calibration(int cycles) {
   ui_print_message(F("\n# Starting Calibration Process..."));
   current_process = Process::CALIBRATION;
   consecutive_read_errors = 0;
-  total_cycles = cycles;
+  total_cycles = min(cycles, MAX_CALIBRATION_CYCLES);
   current_cycle = 1;
+  cycle_record_count = 0;
   process_start_time = millis();
   step_start_time = millis(); // Initialize for the first step
   last_battery_read = 0;
@@ -65,12 +75,46 @@ void ProcessController::start_demo(int cycles) {
   ui_print_message(F("\n# Starting DEMO Process..."));
   current_process = Process::DEMO;
   consecutive_read_errors = 0;
-  total_cycles = cycles;
+  total_cycles = min(cycles, MAX_CALIBRATION_CYCLES);
   current_cycle = 1;
+  cycle_record_count = 0;
   process_start_time = millis();
   step_start_time = millis(); // Initialize for the first step
   last_battery_read = 0;
   calib_step = CalibrationStep::PRE_CALIB_CHARGING;
+  battery.reset_demo_data();
+}
+
+void ProcessController::start_soh_estimate() {
+  ui_print_message(F("\n# Starting SoH Estimation..."));
+  if (!battery.read_data()) {
+    ui_print_message(F("## Cannot start: failed to read battery data."));
+    ui_show_main_menu();
+    return;
+  }
+  if (battery.is_fully_discharged() || battery.is_discharge_inhibited()) {
+    ui_print_message(F("## Cannot start: battery is too low to discharge."));
+    ui_show_main_menu();
+    return;
+  }
+  const BatteryData& data = battery.get_data();
+  uint16_t cells[4];
+  soh_cells = valid_cell_voltages(data, cells);
+  if (soh_cells == 0) soh_cells = max(1, (data.design_voltage + 1800) / 3600); // Nominal 3.6 V per cell
+
+  current_process = Process::SOH_ESTIMATE;
+  consecutive_read_errors = 0;
+  process_start_time = millis();
+  step_start_time = millis();
+  last_battery_read = millis();
+  soh_last_sample = millis();
+  soh_last_attempt = soh_last_sample;
+  soh_resistance_mohm = 0;
+  soh_window_voltage = 0;
+  soh_step = SohStep::RESTING;
+  control_relays(false, false);
+  led_indicate_waiting();
+  ui_print_message(F("## Resting battery for 5 minutes before the pulse..."));
 }
 
 void ProcessController::update() {
@@ -81,6 +125,7 @@ void ProcessController::update() {
     case Process::DISCHARGE:   update_discharge(); break;
     case Process::CALIBRATION: update_calibration_or_demo(false); break;
     case Process::DEMO:        update_calibration_or_demo(true); break;
+    case Process::SOH_ESTIMATE: update_soh_estimate(); break;
     case Process::IDLE: break;
   }
 }
@@ -108,17 +153,23 @@ void ProcessController::update_discharge() {
 }
 
 void ProcessController::update_calibration_or_demo(bool is_demo) {
+  if (is_demo) {
+    // The pack model follows the relays, just like a real pack would.
+    battery.generate_demo_data(discharge_relay_on ? PackModel::DISCHARGE
+                               : charge_relay_on ? PackModel::CHARGE : PackModel::REST);
+    track_cycle_sample(DEMO_TIME_MULTIPLIER);
+  }
   periodic_battery_check(false, is_demo);
   
   unsigned long wait_time = 0;
-  unsigned long process_time = is_demo ? DEMO_PROCESS_DURATION_MS : 0;
+  unsigned long time_scale = is_demo ? DEMO_TIME_MULTIPLIER : 1;
   
   switch (calib_step) {
     case CalibrationStep::PRE_CALIB_CHARGING:
         control_relays(true, false); // Turn on charger
         led_indicate_charge();
-        if ( (is_demo && millis() - step_start_time > process_time) || battery.is_fully_charged() || battery.is_charge_inhibited() || battery.has_error() ) {
-            ui_print_message(F("## Initial charge complete. Starting 30-minute wait..."));
+        if ( battery.is_fully_charged() || battery.is_charge_inhibited() || battery.has_error() ) {
+            ui_print_message(F(MSG_INITIAL_CHARGE_COMPLETE));
             led_indicate_charge_done();
             step_start_time = millis();
             calib_step = CalibrationStep::PRE_CALIB_WAITING;
@@ -126,7 +177,7 @@ void ProcessController::update_calibration_or_demo(bool is_demo) {
         break;
         
     case CalibrationStep::PRE_CALIB_WAITING:
-      wait_time = is_demo ? DEMO_WAIT_DURATION_MS : CALIBRATION_PRE_CHARGE_WAIT_MS;
+      wait_time = CALIBRATION_PRE_CHARGE_WAIT_MS / time_scale;
       if (millis() - step_start_time > wait_time) {
         calib_step = CalibrationStep::START_DISCHARGE;
       }
@@ -136,13 +187,16 @@ void ProcessController::update_calibration_or_demo(bool is_demo) {
         ui_print_message(String(F("\n## --- Cycle ")) + current_cycle + "/" + total_cycles + F(": Starting Discharge Phase ---"));
         control_relays(false, true);
         led_indicate_discharge();
+        begin_cycle_record();
         step_start_time = millis();
         calib_step = CalibrationStep::DISCHARGING;
       break;
 
     case CalibrationStep::DISCHARGING:
-      if ( (is_demo && millis() - step_start_time > process_time) || battery.is_fully_discharged() || battery.is_discharge_inhibited() || battery.has_error() ) {
-        ui_print_message(F("## Discharge phase complete. Starting 5-hour wait."));
+      if ( battery.is_fully_discharged() || battery.is_discharge_inhibited() || battery.has_error() ) {
+        ui_print_message(F(MSG_DISCHARGE_PHASE_COMPLETE));
+        cycle_records[current_cycle - 1].discharge_minutes = (millis() - step_start_time) / 1000 * time_scale / 60;
+        cycle_records[current_cycle - 1].discharge_end = phase_end_reason(false);
         control_relays(false, false);
         led_indicate_waiting();
         step_start_time = millis();
@@ -151,7 +205,7 @@ void ProcessController::update_calibration_or_demo(bool is_demo) {
       break;
 
     case CalibrationStep::POST_DISCHARGE_WAIT:
-      wait_time = is_demo ? DEMO_WAIT_DURATION_MS : CALIBRATION_DISCHARGE_WAIT_MS;
+      wait_time = CALIBRATION_DISCHARGE_WAIT_MS / time_scale;
       if (millis() - step_start_time > wait_time) {
         calib_step = CalibrationStep::START_CHARGE;
       }
@@ -166,8 +220,10 @@ void ProcessController::update_calibration_or_demo(bool is_demo) {
       break;
 
     case CalibrationStep::CHARGING:
-      if ( (is_demo && millis() - step_start_time > process_time) || battery.is_fully_charged() || battery.is_charge_inhibited() || battery.has_error() ) {
-        ui_print_message(F("## Charging phase complete. Starting 1-hour wait."));
+      if ( battery.is_fully_charged() || battery.is_charge_inhibited() || battery.has_error() ) {
+        ui_print_message(F(MSG_CHARGE_PHASE_COMPLETE));
+        cycle_records[current_cycle - 1].charge_minutes = (millis() - step_start_time) / 1000 * time_scale / 60;
+        cycle_records[current_cycle - 1].charge_end = phase_end_reason(true);
         led_indicate_charge_done();
         step_start_time = millis();
         calib_step = CalibrationStep::POST_CHARGE_WAIT;
@@ -175,13 +231,18 @@ void ProcessController::update_calibration_or_demo(bool is_demo) {
       break;
 
     case CalibrationStep::POST_CHARGE_WAIT:
-      wait_time = is_demo ? DEMO_WAIT_DURATION_MS : CALIBRATION_CHARGE_WAIT_MS;
+      wait_time = CALIBRATION_CHARGE_WAIT_MS / time_scale;
       if (millis() - step_start_time > wait_time) {
-        if (current_cycle < total_cycles) {
+        finish_cycle_record();
+        if (current_cycle < total_cycles && fcc_converged()) {
+          ui_print_message(String(F("\n" MSG_FCC_CONVERGED)) + FCC_CONVERGENCE_TOLERANCE_PERCENT
+                           + F("% after ") + current_cycle + F(" cycles. Ending calibration early."));
+          stop_process();
+        } else if (current_cycle < total_cycles) {
           current_cycle++;
           calib_step = CalibrationStep::START_DISCHARGE;
         } else {
-          ui_print_message(F("\n## All calibration cycles complete."));
+          ui_print_message(F("\n" MSG_ALL_CYCLES_COMPLETE));
           stop_process();
         }
       }
@@ -189,31 +250,315 @@ void ProcessController::update_calibration_or_demo(bool is_demo) {
   }
 }
 
+void ProcessController::begin_cycle_record() {
+  const BatteryData& data = battery.get_data();
+  CycleRecord& record = cycle_records[current_cycle - 1];
+  record = CycleRecord();
+  record.fcc_before = data.full_charge_capacity;
+  record.cycle_count_before = data.cycle_count;
+  record.soh_before = data.state_of_health;
+  record.peak_temperature = data.temperature;
+  record.fcc_after = record.fcc_before;
+  record.cycle_count_after = record.cycle_count_before;
+  record.soh_after = record.soh_before;
+  record.discharge_end = PhaseEnd::ABORTED;
+  record.charge_end = PhaseEnd::ABORTED;
+  cycle_discharged_mAs = 0;
+  cycle_discharge_remainder = 0;
+  cycle_last_sample = millis();
+}
+
+// Called after every fresh battery sample while a cycle is in progress.
+void ProcessController::track_cycle_sample(unsigned long time_scale) {
+  if (calib_step < CalibrationStep::DISCHARGING) return;
+
+  unsigned long now = millis();
+  unsigned long dt = (now - cycle_last_sample) * time_scale;
+  cycle_last_sample = now;
+
+  const BatteryData& data = battery.get_data();
+  CycleRecord& record = cycle_records[current_cycle - 1];
+  if (calib_step == CalibrationStep::DISCHARGING && data.current < 0) {
+    cycle_discharge_remainder += (unsigned long)(-(long)data.current) * dt;
+    cycle_discharged_mAs += cycle_discharge_remainder / 1000;
+    cycle_discharge_remainder %= 1000;
+  }
+  // Words that failed to read come back as 0xFFFF. The "after" values follow
+  // the last good reading so an aborted cycle still has them.
+  if (data.temperature != 0xFFFF && data.temperature > record.peak_temperature) record.peak_temperature = data.temperature;
+  if (data.full_charge_capacity != 0xFFFF) {
+    record.fcc_after = data.full_charge_capacity;
+    record.soh_after = data.state_of_health;
+  }
+  if (data.cycle_count != 0xFFFF) record.cycle_count_after = data.cycle_count;
+
+  uint16_t cells[4];
+  uint8_t count = valid_cell_voltages(data, cells);
+  uint16_t lowest = 0xFFFF;
+  uint16_t highest = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    lowest = min(lowest, cells[i]);
+    highest = max(highest, cells[i]);
+  }
+  if (highest > lowest && highest - lowest > record.max_cell_imbalance_mv) {
+    record.max_cell_imbalance_mv = highest - lowest;
+  }
+}
+
+void ProcessController::finish_cycle_record() {
+  CycleRecord& record = cycle_records[current_cycle - 1];
+  record.discharged_mah = (uint16_t)(cycle_discharged_mAs / 3600UL);
+  cycle_record_count = current_cycle;
+  reporter_print_cycle_record(current_cycle, record);
+}
+
+// Closes the record of the cycle in progress; phases that had not ended keep
+// PhaseEnd::ABORTED.
+void ProcessController::record_aborted_cycle() {
+  unsigned long time_scale = current_process == Process::DEMO ? DEMO_TIME_MULTIPLIER : 1;
+  unsigned long minutes = (millis() - step_start_time) / 1000 * time_scale / 60;
+  CycleRecord& record = cycle_records[current_cycle - 1];
+  if (calib_step == CalibrationStep::DISCHARGING) record.discharge_minutes = minutes;
+  else if (calib_step == CalibrationStep::CHARGING) record.charge_minutes = minutes;
+  finish_cycle_record();
+}
+
+// FCC has settled once two consecutive full FD-terminated cycles learned
+// capacities within the tolerance of each other.
+bool ProcessController::fcc_converged() const {
+  if (cycle_record_count < 2) return false;
+  const CycleRecord& last = cycle_records[cycle_record_count - 1];
+  const CycleRecord& previous = cycle_records[cycle_record_count - 2];
+  if (last.discharge_end != PhaseEnd::FLAG || previous.discharge_end != PhaseEnd::FLAG) return false;
+  long change = (long)last.fcc_after - (long)previous.fcc_after;
+  if (change < 0) change = -change;
+  return change * 100L <= (long)FCC_CONVERGENCE_TOLERANCE_PERCENT * previous.fcc_after;
+}
+
+PhaseEnd ProcessController::phase_end_reason(bool charging) const {
+  if (battery.has_error()) return PhaseEnd::BATTERY_ERROR;
+  if (charging ? battery.is_fully_charged() : battery.is_fully_discharged()) return PhaseEnd::FLAG;
+  return PhaseEnd::FET_INHIBIT;
+}
+
+void ProcessController::update_soh_estimate() {
+  unsigned long now = millis();
+  if (now - soh_last_attempt < SOH_SAMPLE_INTERVAL_MS) return;
+  soh_last_attempt = now;
+
+  // A failed read leaves soh_last_sample alone, so the next good sample's dt
+  // covers the gap instead of dropping that charge.
+  if (!sample_live_data()) return;
+  unsigned long dt = now - soh_last_sample;
+  soh_last_sample = now;
+  const BatteryData& data = battery.get_data();
+
+  // The start SoC is the OCV rested before the pulse, so the pulse's charge
+  // counts toward the span as well.
+  if ((soh_step == SohStep::PULSE || soh_step == SohStep::COUNTING) && data.current < 0) {
+    soh_charge_remainder += (unsigned long)(-(long)data.current) * dt;
+    soh_charge_mAs += soh_charge_remainder / 1000;
+    soh_charge_remainder %= 1000;
+  }
+
+  switch (soh_step) {
+    case SohStep::RESTING:
+      soh_rest_voltage = data.voltage;
+      soh_rest_current = data.current;
+      track_relax_window(now);
+      if (now - step_start_time > SOH_REST_DURATION_MS) {
+        soh_start_soc = ocv_soc_permille(soh_rest_voltage / soh_cells);
+        soh_start_error_mv = ocv_error_mv(soh_rest_voltage);
+        ui_print_param(F("Rested SoC from OCV (%)"), String(soh_start_soc / 10.0, 1));
+        ui_print_message(F("## Rest complete. Applying discharge pulse..."));
+        control_relays(false, true);
+        led_indicate_discharge();
+        soh_step_voltage = 0;
+        soh_step_current = 0;
+        soh_step_settled = false;
+        soh_charge_mAs = 0;
+        soh_charge_remainder = 0;
+        step_start_time = now;
+        soh_step = SohStep::PULSE;
+      }
+      break;
+
+    case SohStep::PULSE:
+      // Gauges refresh Voltage() and Current() about once a second and Current()
+      // is usually a 1 s average, so the first loaded sample can pair a partial
+      // current step with a full voltage step. The step is only taken once it
+      // reads the same across a full gauge update period.
+      if (!soh_step_settled && data.current <= soh_rest_current - SOH_PULSE_MIN_CURRENT_MA) {
+        if (soh_step_voltage == 0) {
+          soh_step_voltage = data.voltage;
+          soh_step_current = data.current;
+          soh_step_time = now;
+        } else if (now - soh_step_time >= SOH_GAUGE_UPDATE_MS) {
+          if (abs((int)data.voltage - (int)soh_step_voltage) <= SOH_STEP_SETTLE_MV &&
+              abs((int)data.current - (int)soh_step_current) <= SOH_STEP_SETTLE_MA) {
+            soh_step_voltage = (uint16_t)(((long)soh_step_voltage + data.voltage) / 2);
+            soh_step_current = (int16_t)(((long)soh_step_current + data.current) / 2);
+            soh_step_settled = true;
+          } else {
+            soh_step_voltage = data.voltage;
+            soh_step_current = data.current;
+            soh_step_time = now;
+          }
+        }
+      }
+      if (now - step_start_time > SOH_PULSE_DURATION_MS) {
+        if (soh_step_voltage == 0) {
+          finish_soh_estimate(F("no discharge current detected"));
+          return;
+        }
+        if (!soh_step_settled) ui_print_message(F("## Pulse step did not settle; using the last reading."));
+        // Taken at least one gauge update into the pulse, so this includes part
+        // of the RC polarization on top of the pure ohmic resistance.
+        long drop_mv = (long)soh_rest_voltage - soh_step_voltage;
+        long step_ma = (long)soh_rest_current - soh_step_current;
+        soh_resistance_mohm = (uint16_t)(drop_mv > 0 ? drop_mv * 1000L / step_ma : 0);
+        ui_print_param(F("Internal Resistance (mOhm)"), String(soh_resistance_mohm));
+        ui_print_message(String(F("## Pulse complete. Coulomb counting about ")) + SOH_TARGET_SOC_DELTA + F("% of charge..."));
+        soh_guide_soc = data.relative_state_of_charge;
+        step_start_time = now;
+        soh_step = SohStep::COUNTING;
+      }
+      break;
+
+    case SohStep::COUNTING:
+      // The gauge's RSOC only decides when to stop; the estimate uses rested OCV.
+      if ((int)soh_guide_soc - (int)data.relative_state_of_charge >= SOH_TARGET_SOC_DELTA) {
+        start_soh_end_rest(F("target SoC span reached"));
+      } else if (battery.has_error()) {
+        finish_soh_estimate(F("battery error"));
+      } else if (battery.is_fully_discharged() || battery.is_discharge_inhibited()) {
+        start_soh_end_rest(F("battery fully discharged"));
+      } else if (now - process_start_time > SOH_MAX_DURATION_MS - SOH_REST_DURATION_MS) {
+        start_soh_end_rest(F("time limit reached"));
+      }
+      break;
+
+    case SohStep::END_REST:
+      track_relax_window(now);
+      if (now - step_start_time > SOH_REST_DURATION_MS) {
+        finish_soh_estimate(soh_finish_reason);
+      }
+      break;
+  }
+
+  if (is_busy() && now - last_battery_read >= BATTERY_READ_INTERVAL_MS) {
+    last_battery_read = now;
+    ui_print_message(F("\n  ===== SOH ESTIMATION STATUS ====="));
+    ui_print_param(F("Elapsed Time (s)"), String((now - process_start_time) / 1000));
+    ui_print_param(F("Voltage (mV)    "), String(data.voltage));
+    ui_print_param(F("Current (mA)    "), String(data.current));
+    ui_print_param(F("Relative SoC (%)"), String(data.relative_state_of_charge));
+    if (soh_step != SohStep::RESTING) {
+      ui_print_param(F("Counted (mAh)   "), String(soh_charge_mAs / 3600UL));
+    }
+  }
+}
+
+void ProcessController::start_soh_end_rest(const __FlashStringHelper* reason) {
+  ui_print_message(String(F("## Counting stopped: ")) + reason + F(". Resting 5 minutes for the final OCV..."));
+  control_relays(false, false);
+  led_indicate_waiting();
+  soh_finish_reason = reason;
+  soh_window_voltage = 0;
+  step_start_time = millis();
+  soh_step = SohStep::END_REST;
+}
+
+// Remembers the voltage where the last SOH_RELAX_WINDOW_MS of a rest begins.
+void ProcessController::track_relax_window(unsigned long now) {
+  if (soh_window_voltage == 0 && now - step_start_time >= SOH_REST_DURATION_MS - SOH_RELAX_WINDOW_MS) {
+    soh_window_voltage = battery.get_data().voltage;
+  }
+}
+
+// Per-cell OCV error at the end of a rest: the reading error plus the
+// relaxation still to come. The latter is extrapolated from the drift over
+// the last window, assuming a time constant about as long as the rest.
+uint16_t ProcessController::ocv_error_mv(uint16_t rested_voltage) const {
+  uint16_t drift_mv = soh_window_voltage == 0 ? 0 : (uint16_t)abs((long)rested_voltage - soh_window_voltage) / soh_cells;
+  return SOH_OCV_ERROR_MV + drift_mv * (SOH_REST_DURATION_MS / SOH_RELAX_WINDOW_MS);
+}
+
+void ProcessController::finish_soh_estimate(const __FlashStringHelper* reason) {
+  control_relays(false, false);
+  ui_print_message(String(F("\n" MSG_SOH_FINISHED)) + reason);
+
+  const BatteryData& data = battery.get_data();
+  uint16_t start_cell_mv = soh_rest_voltage / soh_cells;
+  uint16_t end_cell_mv = data.voltage / soh_cells;
+  int16_t end_soc = ocv_soc_permille(end_cell_mv);
+  int soc_delta = (int)soh_start_soc - end_soc;
+  if (soh_step != SohStep::END_REST || soc_delta < SOH_MIN_SOC_DELTA * 10) {
+    ui_print_message(F("## Not enough charge was counted for an estimate."));
+    stop_process();
+    return;
+  }
+
+  // Both SoC points come from rested OCV, so the result is independent of the
+  // gauge's learned FCC. soc_delta is in permille.
+  unsigned long capacity_mAh = (soh_charge_mAs / 36UL) * 10UL / soc_delta;
+  uint16_t soh = data.design_capacity > 0 ? (uint16_t)(capacity_mAh * 100UL / data.design_capacity) : 0;
+
+  // Confidence follows how far each point's OCV error moves its SoC relative
+  // to the span, so unfinished relaxation and flat parts of the curve score lower.
+  uint16_t end_error_mv = ocv_error_mv(data.voltage);
+  int start_error = (ocv_soc_permille(start_cell_mv + soh_start_error_mv) - ocv_soc_permille(start_cell_mv - soh_start_error_mv)) / 2;
+  int end_error = (ocv_soc_permille(end_cell_mv + end_error_mv) - ocv_soc_permille(end_cell_mv - end_error_mv)) / 2;
+  int relative_error_pct = (int)((start_error + end_error) * 100L / soc_delta);
+  int confidence = constrain(100 - relative_error_pct, 0, 100);
+
+  ui_print_message(F("\n  ===== SOH ESTIMATE ====="));
+  ui_print_param(F("Internal Resistance (mOhm) "), String(soh_resistance_mohm));
+  ui_print_param(F("Counted Charge (mAh)       "), String(soh_charge_mAs / 3600UL));
+  ui_print_param(F("OCV SoC Start -> End (%)   "), String(soh_start_soc / 10.0, 1) + " -> " + String(end_soc / 10.0, 1));
+  ui_print_param(F("OCV Error Start / End (mV) "), String(soh_start_error_mv) + " / " + String(end_error_mv));
+  ui_print_param(F(MSG_SOH_CAPACITY), String(capacity_mAh));
+  ui_print_param(F("Estimated SoH (%)          "), String(soh));
+  ui_print_param(F(MSG_SOH_CONFIDENCE), String(confidence));
+  ui_print_param(F("Gauge SoH, for reference   "), String(data.state_of_health));
+  stop_process();
+}
+
+bool ProcessController::sample_live_data() {
+  if (!battery.read_live_data()) {
+    register_read_error();
+    return false;
+  }
+  consecutive_read_errors = 0;
+  return true;
+}
+
+void ProcessController::register_read_error() {
+  consecutive_read_errors++;
+  ui_print_message(String(F(MSG_READ_ERROR)) + consecutive_read_errors + "/3)");
+  if (consecutive_read_errors >= 3) {
+    ui_print_message(F(MSG_READ_ERROR_ABORT));
+    stop_process();
+  }
+}
+
 void ProcessController::periodic_battery_check(bool full_report, bool is_demo) {
   if (millis() - last_battery_read >= BATTERY_READ_INTERVAL_MS) {
     last_battery_read = millis();
     
-    if (is_demo) {
-      int state = 0;
-      if (calib_step == CalibrationStep::CHARGING || calib_step == CalibrationStep::PRE_CALIB_CHARGING) state = 1;
-      else if (calib_step != CalibrationStep::DISCHARGING) state = 2;
-      battery.generate_demo_data(state);
-    } else {
+    if (!is_demo) {
       if (!battery.read_data()) {
-        consecutive_read_errors++;
-        ui_print_message(String(F("## Error reading battery data (Attempt ")) + consecutive_read_errors + "/3)");
-        if (consecutive_read_errors >= 3) {
-          ui_print_message(F("## Aborting process due to too many read errors."));
-          stop_process();
-        }
+        register_read_error();
         return;
       } else {
         consecutive_read_errors = 0;
       }
+      if (current_process == Process::CALIBRATION) track_cycle_sample(1);
     }
     
     if(current_process == Process::CALIBRATION || current_process == Process::DEMO) {
         unsigned long elapsed = (millis() - process_start_time) / 1000;
+        if (is_demo) elapsed *= DEMO_TIME_MULTIPLIER; // Report simulated pack time
         unsigned long hours = elapsed / 3600;
         unsigned long mins = (elapsed % 3600) / 60;
         unsigned long secs = elapsed % 60;
@@ -229,6 +574,8 @@ void ProcessController::periodic_battery_check(bool full_report, bool is_demo) {
   }
 }
 void ProcessController::control_relays(bool charge, bool discharge) {
+    charge_relay_on = charge;
+    discharge_relay_on = discharge;
     digitalWrite(RELAY_PIN_CHARGE, charge ? RELAY_ON : RELAY_OFF);
     digitalWrite(RELAY_PIN_DISCHARGE, discharge ? RELAY_ON : RELAY_OFF);
 }
@@ -2,13 +2,16 @@
 #define PROCESS_CONTROLLER_H
 
 #include "battery_manager.h"
+#include "cycle_record.h"
+#include "config.h"
 
 enum class Process {
   IDLE,
   CHARGE,
   DISCHARGE,
   CALIBRATION,
-  DEMO
+  DEMO,
+  SOH_ESTIMATE
 };
 
 class ProcessController {
@@ -19,6 +22,7 @@ public:
   void start_discharge();
   void start_calibration(int cycles);
   void start_demo(int cycles);
+  void start_soh_estimate();
   void stop_process();
   void update();
   bool is_busy() const;
@@ -39,14 +43,58 @@ private:
     POST_CHARGE_WAIT
   };
   CalibrationStep calib_step;
+  CycleRecord cycle_records[MAX_CALIBRATION_CYCLES];
+  int cycle_record_count;
+  unsigned long cycle_last_sample;
+  unsigned long cycle_discharged_mAs;
+  unsigned long cycle_discharge_remainder;
+  enum class SohStep {
+    RESTING,
+    PULSE,
+    COUNTING,
+    END_REST
+  };
+  SohStep soh_step;
+  unsigned long soh_last_sample;
+  unsigned long soh_last_attempt;
+  unsigned long soh_charge_mAs;
+  unsigned long soh_charge_remainder;
+  uint16_t soh_rest_voltage;
+  uint16_t soh_window_voltage;
+  uint16_t soh_start_error_mv;
+  int16_t soh_rest_current;
+  uint16_t soh_step_voltage;
+  int16_t soh_step_current;
+  unsigned long soh_step_time;
+  bool soh_step_settled;
+  uint16_t soh_resistance_mohm;
+  uint8_t soh_cells;
+  int16_t soh_start_soc;
+  uint16_t soh_guide_soc;
+  const __FlashStringHelper* soh_finish_reason;
   unsigned long process_start_time;
   unsigned long step_start_time;
   unsigned long last_battery_read;
   int consecutive_read_errors;
+  bool charge_relay_on;
+  bool discharge_relay_on;
   void control_relays(bool charge, bool discharge);
   void update_charge();
   void update_discharge();
   void update_calibration_or_demo(bool is_demo);
+  void begin_cycle_record();
+  void track_cycle_sample(unsigned long time_scale);
+  void finish_cycle_record();
+  void record_aborted_cycle();
+  bool fcc_converged() const;
+  PhaseEnd phase_end_reason(bool charging) const;
+  void update_soh_estimate();
+  void start_soh_end_rest(const __FlashStringHelper* reason);
+  void track_relax_window(unsigned long now);
+  uint16_t ocv_error_mv(uint16_t rested_voltage) const;
+  void finish_soh_estimate(const __FlashStringHelper* reason);
+  bool sample_live_data();
+  void register_read_error();
   void periodic_battery_check(bool full_report, bool is_demo = false);
 };
 
@@ -0,0 +1,17 @@
+#ifndef PROCESS_MESSAGES_H
+#define PROCESS_MESSAGES_H
+
+// Console messages that mark calibration and SoH events. The host simulator
+// (host/sim) recognizes the events by these texts, so reword them only here.
+#define MSG_INITIAL_CHARGE_COMPLETE  "## Initial charge complete. Starting 30-minute wait..."
+#define MSG_DISCHARGE_PHASE_COMPLETE "## Discharge phase complete. Starting 5-hour wait."
+#define MSG_CHARGE_PHASE_COMPLETE    "## Charging phase complete. Starting 1-hour wait."
+#define MSG_FCC_CONVERGED            "## FCC converged within "
+#define MSG_ALL_CYCLES_COMPLETE      "## All calibration cycles complete."
+#define MSG_READ_ERROR               "## Error reading battery data (Attempt "
+#define MSG_READ_ERROR_ABORT         "## Aborting process due to too many read errors."
+#define MSG_SOH_FINISHED             "## SoH estimation finished: "
+#define MSG_SOH_CAPACITY             "Estimated Capacity (mAh)   "
+#define MSG_SOH_CONFIDENCE           "Confidence (%)             "
+
+#endif // PROCESS_MESSAGES_H
@@ -0,0 +1,164 @@
+#ifndef SMBUS_SOFTWIRE_H
+#define SMBUS_SOFTWIRE_H
+
+#include <Arduino.h>
+
+// Bit-banged SMBus master on arbitrary pins. The lines are driven open-drain
+// by toggling only the DDR bit (PORT stays low), so external pull-ups are
+// required, as on any SMBus. Port registers and masks are looked up once in
+// begin() and every edge afterwards is a single read-modify-write.
+template <uint8_t SDA_PIN, uint8_t SCL_PIN>
+class SoftWireBus {
+public:
+  void begin() {
+    sda_ddr = portModeRegister(digitalPinToPort(SDA_PIN));
+    sda_in = portInputRegister(digitalPinToPort(SDA_PIN));
+    sda_mask = digitalPinToBitMask(SDA_PIN);
+    scl_ddr = portModeRegister(digitalPinToPort(SCL_PIN));
+    scl_in = portInputRegister(digitalPinToPort(SCL_PIN));
+    scl_mask = digitalPinToBitMask(SCL_PIN);
+
+    uint8_t oldSREG = SREG;
+    cli();
+    *portOutputRegister(digitalPinToPort(SDA_PIN)) &= ~sda_mask;
+    *portOutputRegister(digitalPinToPort(SCL_PIN)) &= ~scl_mask;
+    SREG = oldSREG;
+    sda_release();
+    scl_release();
+  }
+
+  uint8_t probe(uint8_t address) {
+    bool ack = start() && write_byte(address << 1);
+    stop();
+    return ack ? 0 : 2;
+  }
+
+  bool read_word(uint8_t address, uint8_t command, uint16_t& value) {
+    if (!select(address, command)) return false;
+    uint8_t lowByte, highByte;
+    bool ok = read_byte(true, lowByte) && read_byte(false, highByte);
+    stop();
+    if (ok) value = (uint16_t)highByte << 8 | lowByte;
+    return ok;
+  }
+
+  // SMBus block read: only the bytes announced by the count byte are clocked.
+  bool read_block(uint8_t address, uint8_t command, char* buffer, uint8_t size) {
+    if (!select(address, command)) return false;
+    uint8_t count;
+    if (!read_byte(true, count)) {
+      stop();
+      return false;
+    }
+    if (count > 32) count = 32;
+    uint8_t len = count < size ? count : size - 1;
+    uint8_t c;
+    bool ok = count > 0 || read_byte(false, c);
+    for (uint8_t i = 0; ok && i < count; i++) {
+      ok = read_byte(i + 1 < count, c);
+      if (i < len) buffer[i] = c;
+    }
+    stop();
+    buffer[len] = '\0';
+    return ok;
+  }
+
+private:
+  static const uint8_t LOW_PERIOD_US = 5;                 // SMBus tLOW >= 4.7 us, also tBUF and tSU:STA
+  static const uint8_t HIGH_PERIOD_US = 4;                // SMBus tHIGH >= 4.0 us, also tHD:STA and tSU:STO
+  static const unsigned long STRETCH_TIMEOUT_US = 30000;  // SMBus tTIMEOUT is 25-35 ms
+
+  volatile uint8_t* sda_ddr;
+  volatile uint8_t* sda_in;
+  volatile uint8_t* scl_ddr;
+  volatile uint8_t* scl_in;
+  uint8_t sda_mask;
+  uint8_t scl_mask;
+
+  // DDR bits share a register with other pins, so updates must not be interrupted.
+  void sda_low()     { uint8_t s = SREG; cli(); *sda_ddr |= sda_mask; SREG = s; }
+  void sda_release() { uint8_t s = SREG; cli(); *sda_ddr &= ~sda_mask; SREG = s; }
+  void scl_low()     { uint8_t s = SREG; cli(); *scl_ddr |= scl_mask; SREG = s; }
+  void scl_release() { uint8_t s = SREG; cli(); *scl_ddr &= ~scl_mask; SREG = s; }
+  bool sda_read() const { return (*sda_in & sda_mask) != 0; }
+
+  // Releases SCL and waits for the slave to stop stretching the clock.
+  bool scl_high() {
+    scl_release();
+    unsigned long started = micros();
+    while (!(*scl_in & scl_mask)) {
+      if (micros() - started >= STRETCH_TIMEOUT_US) return false;
+    }
+    delayMicroseconds(HIGH_PERIOD_US);
+    return true;
+  }
+
+  // Also used as repeated start, where SCL is low on entry and SDA must stay
+  // high for tSU:STA after SCL rises.
+  bool start() {
+    sda_release();
+    delayMicroseconds(LOW_PERIOD_US);
+    if (!scl_high()) return false;
+    delayMicroseconds(LOW_PERIOD_US - HIGH_PERIOD_US); // Stretch the high phase to tSU:STA
+    sda_low();
+    delayMicroseconds(HIGH_PERIOD_US);
+    scl_low();
+    return true;
+  }
+
+  void stop() {
+    sda_low();
+    delayMicroseconds(LOW_PERIOD_US);
+    scl_high();
+    sda_release();
+    delayMicroseconds(LOW_PERIOD_US);
+  }
+
+  bool write_byte(uint8_t value) {
+    for (uint8_t bit = 0x80; bit; bit >>= 1) {
+      if (value & bit) sda_release(); else sda_low();
+      delayMicroseconds(LOW_PERIOD_US);
+      if (!scl_high()) return false;
+      scl_low();
+    }
+    sda_release();
+    delayMicroseconds(LOW_PERIOD_US);
+    if (!scl_high()) return false;
+    bool ack = !sda_read();
+    scl_low();
+    return ack;
+  }
+
+  // Fails if the slave holds SCL past the timeout; the caller sends the stop.
+  bool read_byte(bool ack, uint8_t& value) {
+    value = 0;
+    sda_release();
+    for (uint8_t i = 0; i < 8; i++) {
+      delayMicroseconds(LOW_PERIOD_US);
+      if (!scl_high()) {
+        scl_low();
+        return false;
+      }
+      value = (value << 1) | (sda_read() ? 1 : 0);
+      scl_low();
+    }
+    if (ack) sda_low();
+    delayMicroseconds(LOW_PERIOD_US);
+    bool ok = scl_high();
+    scl_low();
+    sda_release();
+    return ok;
+  }
+
+  // Write phase of a read transaction, ending in a repeated start for reading.
+  bool select(uint8_t address, uint8_t command) {
+    if (!start() || !write_byte(address << 1) || !write_byte(command) ||
+        !start() || !write_byte((address << 1) | 1)) {
+      stop();
+      return false;
+    }
+    return true;
+  }
+};
+
+#endif // SMBUS_SOFTWIRE_H
@@ -0,0 +1,49 @@
+#ifndef SMBUS_TWI_H
+#define SMBUS_TWI_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// SMBus backend on the hardware TWI peripheral (A4/A5) through the Wire library.
+class TwiBus {
+public:
+  void begin() {
+    Wire.begin();
+  }
+
+  uint8_t probe(uint8_t address) {
+    Wire.beginTransmission(address);
+    return Wire.endTransmission();
+  }
+
+  bool read_word(uint8_t address, uint8_t command, uint16_t& value) {
+    Wire.beginTransmission(address);
+    Wire.write(command);
+    if (Wire.endTransmission(false) != 0) return false;
+    if (Wire.requestFrom(address, (uint8_t)2) != 2) return false;
+    byte lowByte = Wire.read();
+    byte highByte = Wire.read();
+    value = (uint16_t)highByte << 8 | lowByte;
+    return true;
+  }
+
+  // Block read into a NUL-terminated buffer; false if the command was not acknowledged.
+  bool read_block(uint8_t address, uint8_t command, char* buffer, uint8_t size) {
+    Wire.beginTransmission(address);
+    Wire.write(command);
+    if (Wire.endTransmission(false) != 0) return false;
+
+    uint8_t len = 0;
+    if (Wire.requestFrom(address, (uint8_t)32, (uint8_t)true) > 0) {
+      len = Wire.read();
+      if (len > size - 1) len = size - 1;
+      for (uint8_t i = 0; i < len; i++) {
+        buffer[i] = Wire.read();
+      }
+    }
+    buffer[len] = '\0';
+    return true;
+  }
+};
+
+#endif // SMBUS_TWI_H
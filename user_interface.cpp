@@ -8,15 +8,20 @@ void ui_show_main_menu() {
   Serial.println(F("3. Start Charge"));
   Serial.println(F("4. Start Discharge"));
   Serial.println(F("5. Demo"));
+  Serial.println(F("6. Estimate SoH (fast)"));
   Serial.print(F("Enter your choice: "));
 }
 
 void ui_prompt_for_cycles() {
-  Serial.print(F("Enter cycles count [1...5] (0 to return to menu): "));
+  Serial.print(F("Enter cycles count [1..."));
+  Serial.print(MAX_CALIBRATION_CYCLES);
+  Serial.print(F("] (0 to return to menu): "));
 }
 
 void ui_prompt_invalid_cycles() {
-  Serial.println(F("Invalid input. Please enter a number between 1 and 5, or 0 to exit."));
+  Serial.print(F("Invalid input. Please enter a number between 1 and "));
+  Serial.print(MAX_CALIBRATION_CYCLES);
+  Serial.println(F(", or 0 to exit."));
 }
 
 void ui_print_message(const String& message, bool new_line) {